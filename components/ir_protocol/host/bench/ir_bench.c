@@ -0,0 +1,735 @@
+// Throughput benchmark for the ir_protocol builder/parser hot path.
+//
+// Usage: ir_bench [iterations]
+//
+// Every vtable entry on the encode/decode path is timed in isolation and
+// reported as ns/frame and frames/s. Received frames are produced by looping
+// the builder output back the way the IR receiver would present it: levels
+// inverted, terminator dropped and the trailing space cut by idle_threshold.
+// The correctness checks along the way exit with EXIT_FAILURE; CTest runs them as bench_checks.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "esp_log.h"
+#include "driver/rmt.h"
+#include "ir_tools.h"
+#include "ir_tx_queue.h"
+#include "ir_aircon.h"
+#include "ir_capture.h"
+#include "ir_filter.h"
+#include "ir_latency.h"
+#include "ir_trace.h"
+
+#define BENCH_DEFAULT_ITERATIONS (1000000)
+#define BENCH_ADDRESS (0xB24D)
+#define BENCH_RX_FRAME_ITEMS (50)
+#define BENCH_STREAM_CHUNK (16)
+#define BENCH_BURST_FRAMES (5)
+#define BENCH_STATE_BYTES (35)
+#define BENCH_LONG_FRAMES (5)  // 30 bytes, 240 payload items
+#define BENCH_GLITCH_TICKS (20)
+
+static const uint32_t s_commands[2] = {0xdd2207f8, 0xf80721de};
+
+static volatile uint32_t s_sink;
+
+static uint64_t bench_now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static void bench_report(const char *name, uint32_t iterations, uint64_t elapsed_ns)
+{
+    double ns_per_frame = (double)elapsed_ns / iterations;
+    printf("%-18s %10u %12.1f %14.0f\n", name, iterations, ns_per_frame, 1e9 / ns_per_frame);
+}
+
+static void bench_loopback(const rmt_item32_t *tx, rmt_item32_t *rx, size_t length)
+{
+    for (size_t i = 0; i < length; i++) {
+        rx[i] = tx[i];
+        rx[i].level0 = !tx[i].level0;
+        rx[i].level1 = !tx[i].level1;
+    }
+    rx[length - 1].duration1 = 0;
+}
+
+int main(int argc, char **argv)
+{
+    uint32_t iterations = BENCH_DEFAULT_ITERATIONS;
+    if (argc > 1) {
+        iterations = (uint32_t)strtoul(argv[1], NULL, 0);
+    }
+    if (!iterations) {
+        fprintf(stderr, "usage: %s [iterations]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+    esp_log_level_set("*", ESP_LOG_NONE);
+
+    ir_builder_config_t builder_config = IR_BUILDER_DEFAULT_CONFIG((ir_dev_t)RMT_CHANNEL_0);
+    builder_config.flags |= IR_TOOLS_FLAGS_PROTO_EXT;
+    builder_config.buffer_size = 128;
+    ir_builder_t *builder = ir_builder_rmt_new_samsung(&builder_config);
+    ir_parser_config_t parser_config = IR_PARSER_DEFAULT_CONFIG((ir_dev_t)RMT_CHANNEL_1);
+    parser_config.flags |= IR_TOOLS_FLAGS_PROTO_EXT;
+    ir_parser_t *parser = ir_parser_rmt_new_samsung(&parser_config);
+    if (!builder || !parser) {
+        fprintf(stderr, "failed to create builder/parser\n");
+        return EXIT_FAILURE;
+    }
+
+    // Pre-build one received frame per command and check they round-trip
+    rmt_item32_t rx_frames[2][BENCH_RX_FRAME_ITEMS];
+    for (int i = 0; i < 2; i++) {
+        rmt_item32_t *items = NULL;
+        size_t length = 0;
+        uint32_t addr = 0;
+        uint32_t cmd = 0;
+        bool repeat = false;
+        ESP_ERROR_CHECK(builder->build_frame(builder, BENCH_ADDRESS, s_commands[i]));
+        ESP_ERROR_CHECK(builder->get_result(builder, &items, &length));
+        if (length < BENCH_RX_FRAME_ITEMS) {
+            fprintf(stderr, "unexpected frame length %zu\n", length);
+            return EXIT_FAILURE;
+        }
+        bench_loopback(items, rx_frames[i], BENCH_RX_FRAME_ITEMS);
+        ESP_ERROR_CHECK(parser->input(parser, rx_frames[i], BENCH_RX_FRAME_ITEMS));
+        ESP_ERROR_CHECK(parser->get_scan_code(parser, &addr, &cmd, &repeat));
+        if (addr != BENCH_ADDRESS || cmd != s_commands[i]) {
+            fprintf(stderr, "round trip mismatch: addr 0x%x cmd 0x%x\n", addr, cmd);
+            return EXIT_FAILURE;
+        }
+    }
+
+    // A space between logic 0 and logic 1 matches neither: the frame is rejected, not decoded as the nearer level
+    rmt_item32_t corrupt[BENCH_RX_FRAME_ITEMS];
+    memcpy(corrupt, rx_frames[0], sizeof(corrupt));
+    corrupt[5].duration1 = 1100;
+    if (parser->input(parser, corrupt, BENCH_RX_FRAME_ITEMS) == ESP_OK) {
+        uint32_t addr = 0;
+        uint32_t cmd = 0;
+        bool repeat = false;
+        if (parser->get_scan_code(parser, &addr, &cmd, &repeat) == ESP_OK) {
+            fprintf(stderr, "bit space between logic 0 and 1 decoded: addr 0x%x cmd 0x%x\n", addr, cmd);
+            return EXIT_FAILURE;
+        }
+    }
+
+    printf("%-18s %10s %12s %14s\n", "operation", "frames", "ns/frame", "frames/s");
+
+    uint64_t start = bench_now_ns();
+    for (uint32_t i = 0; i < iterations; i++) {
+        s_sink += builder->build_frame(builder, BENCH_ADDRESS, s_commands[i & 1]);
+    }
+    bench_report("build_frame", iterations, bench_now_ns() - start);
+
+    // Every command distinct, so each call misses the frame cache and encodes
+    start = bench_now_ns();
+    for (uint32_t i = 0; i < iterations; i++) {
+        s_sink += builder->build_frame(builder, BENCH_ADDRESS, i);
+    }
+    bench_report("build_frame_miss", iterations, bench_now_ns() - start);
+
+    // Streamed frame through the RMT translator: the 6 payload bytes of a Samsung frame must give the built items
+    rmt_item32_t streamed[BENCH_STATE_BYTES * 8 + 8];
+    size_t streamed_length = 0;
+    rmt_mock_set_tx_sink(RMT_CHANNEL_0, streamed, sizeof(streamed) / sizeof(streamed[0]), &streamed_length);
+    uint8_t state[BENCH_STATE_BYTES];
+    for (int i = 0; i < BENCH_STATE_BYTES; i++) {
+        state[i] = i < 2 ? (BENCH_ADDRESS >> (8 * i)) & 0xFF : i < 6 ? (s_commands[0] >> (8 * (i - 2))) & 0xFF : i * 37;
+    }
+    rmt_item32_t *built = NULL;
+    size_t built_length = 0;
+    ESP_ERROR_CHECK(builder->build_frame(builder, BENCH_ADDRESS, s_commands[0]));
+    ESP_ERROR_CHECK(builder->get_result(builder, &built, &built_length));
+    ESP_ERROR_CHECK(ir_builder_rmt_stream_frame(builder, state, 6, true));
+    if (streamed_length != built_length - 1 || memcmp(streamed, built, streamed_length * sizeof(rmt_item32_t))) {
+        fprintf(stderr, "streamed frame differs from built frame\n");
+        return EXIT_FAILURE;
+    }
+    // A frame longer than the first fill of channel RAM is refilled mid-byte and mid-gap: streaming
+    // BENCH_LONG_FRAMES Samsung payloads back to back must give their built payload items in order
+    rmt_item32_t long_streamed[1 + BENCH_LONG_FRAMES * 48 + 16];
+    rmt_item32_t long_expected[1 + BENCH_LONG_FRAMES * 48 + 16];
+    uint8_t long_state[BENCH_LONG_FRAMES * 6];
+    size_t long_expected_length = 1;
+    rmt_mock_set_tx_sink(RMT_CHANNEL_0, long_streamed, sizeof(long_streamed) / sizeof(long_streamed[0]), &streamed_length);
+    for (int f = 0; f < BENCH_LONG_FRAMES; f++) {
+        uint32_t command = s_commands[f & 1] ^ (f * 0x01010101);
+        for (int i = 0; i < 6; i++) {
+            long_state[f * 6 + i] = i < 2 ? (BENCH_ADDRESS >> (8 * i)) & 0xFF : (command >> (8 * (i - 2))) & 0xFF;
+        }
+        ESP_ERROR_CHECK(builder->build_frame(builder, BENCH_ADDRESS, command));
+        ESP_ERROR_CHECK(builder->get_result(builder, &built, &built_length));
+        long_expected[0] = built[0];
+        memcpy(&long_expected[long_expected_length], &built[1], 48 * sizeof(rmt_item32_t));
+        long_expected_length += 48;
+    }
+    // Ending code and gap of the last frame, without the terminator
+    memcpy(&long_expected[long_expected_length], &built[49], (built_length - 50) * sizeof(rmt_item32_t));
+    long_expected_length += built_length - 50;
+    ESP_ERROR_CHECK(ir_builder_rmt_stream_frame(builder, long_state, sizeof(long_state), true));
+    if (streamed_length != long_expected_length ||
+        memcmp(long_streamed, long_expected, long_expected_length * sizeof(rmt_item32_t))) {
+        fprintf(stderr, "long streamed frame differs from built frames: %zu items, expected %zu\n",
+                streamed_length, long_expected_length);
+        return EXIT_FAILURE;
+    }
+    rmt_mock_set_tx_sink(RMT_CHANNEL_0, streamed, sizeof(streamed) / sizeof(streamed[0]), &streamed_length);
+    start = bench_now_ns();
+    for (uint32_t i = 0; i < iterations; i++) {
+        s_sink += ir_builder_rmt_stream_frame(builder, state, BENCH_STATE_BYTES, false);
+    }
+    bench_report("stream_frame_35B", iterations, bench_now_ns() - start);
+    rmt_mock_set_tx_sink(RMT_CHANNEL_0, NULL, 0, NULL);
+
+    // Frame, gap and repeated frame as one result
+    start = bench_now_ns();
+    for (uint32_t i = 0; i < iterations; i++) {
+        builder->build_frame(builder, BENCH_ADDRESS, s_commands[i & 1]);
+        s_sink += builder->build_repeat_frame(builder);
+    }
+    bench_report("build_repeat", iterations, bench_now_ns() - start);
+
+    // The same sequence in one call, encoded straight into one slot: a slot per command, every one cached
+    rmt_item32_t repeated[2 * BENCH_RX_FRAME_ITEMS + 8];
+    size_t repeated_length = 0;
+    ESP_ERROR_CHECK(builder->build_frame(builder, BENCH_ADDRESS, s_commands[0]));
+    ESP_ERROR_CHECK(builder->build_repeat_frame(builder));
+    ESP_ERROR_CHECK(builder->get_result(builder, &built, &repeated_length));
+    memcpy(repeated, built, repeated_length * sizeof(rmt_item32_t));
+    ESP_ERROR_CHECK(ir_builder_rmt_build_repeated_frame(builder, BENCH_ADDRESS, s_commands[0]));
+    ESP_ERROR_CHECK(builder->get_result(builder, &built, &built_length));
+    if (built_length != repeated_length || memcmp(built, repeated, built_length * sizeof(rmt_item32_t))) {
+        fprintf(stderr, "repeated frame differs from build_frame + build_repeat_frame\n");
+        return EXIT_FAILURE;
+    }
+    uint32_t repeated_hits = 0;
+    uint32_t repeated_misses = 0;
+    uint32_t hits_before = 0;
+    for (uint32_t i = 0; i < IR_BUILDER_RMT_CACHE_SLOTS; i++) {
+        ESP_ERROR_CHECK(ir_builder_rmt_build_repeated_frame(builder, BENCH_ADDRESS, 0x1000 + i));
+    }
+    ESP_ERROR_CHECK(ir_builder_rmt_get_cache_stats(builder, &hits_before, &repeated_misses));
+    for (uint32_t i = 0; i < IR_BUILDER_RMT_CACHE_SLOTS; i++) {
+        ESP_ERROR_CHECK(ir_builder_rmt_build_repeated_frame(builder, BENCH_ADDRESS, 0x1000 + i));
+    }
+    ESP_ERROR_CHECK(ir_builder_rmt_get_cache_stats(builder, &repeated_hits, &repeated_misses));
+    if (repeated_hits - hits_before != IR_BUILDER_RMT_CACHE_SLOTS) {
+        fprintf(stderr, "%u of %d repeated commands cached\n", repeated_hits - hits_before, IR_BUILDER_RMT_CACHE_SLOTS);
+        return EXIT_FAILURE;
+    }
+    start = bench_now_ns();
+    for (uint32_t i = 0; i < iterations; i++) {
+        s_sink += ir_builder_rmt_build_repeated_frame(builder, BENCH_ADDRESS, s_commands[i & 1]);
+    }
+    bench_report("build_repeated", iterations, bench_now_ns() - start);
+
+    start = bench_now_ns();
+    for (uint32_t i = 0; i < iterations; i++) {
+        rmt_item32_t *items = NULL;
+        size_t length = 0;
+        builder->get_result(builder, &items, &length);
+        s_sink += length;
+    }
+    bench_report("get_result", iterations, bench_now_ns() - start);
+
+    start = bench_now_ns();
+    for (uint32_t i = 0; i < iterations; i++) {
+        s_sink += parser->input(parser, rx_frames[i & 1], BENCH_RX_FRAME_ITEMS);
+    }
+    bench_report("input", iterations, bench_now_ns() - start);
+
+    // get_scan_code decodes whatever was last handed to input, so alternate
+    // the frame outside the timed region per batch to keep both commands hot
+    uint64_t elapsed = 0;
+    for (int f = 0; f < 2; f++) {
+        parser->input(parser, rx_frames[f], BENCH_RX_FRAME_ITEMS);
+        start = bench_now_ns();
+        for (uint32_t i = 0; i < iterations / 2; i++) {
+            uint32_t addr = 0;
+            uint32_t cmd = 0;
+            bool repeat = false;
+            parser->get_scan_code(parser, &addr, &cmd, &repeat);
+            s_sink += cmd;
+        }
+        elapsed += bench_now_ns() - start;
+    }
+    bench_report("get_scan_code", iterations / 2 * 2, elapsed);
+
+    // Corrupt frame: the decoder should give up at the damaged bit
+    rmt_item32_t bad_frame[BENCH_RX_FRAME_ITEMS];
+    memcpy(bad_frame, rx_frames[0], sizeof(bad_frame));
+    bad_frame[1 + 4].duration1 = 3000;
+    parser->input(parser, bad_frame, BENCH_RX_FRAME_ITEMS);
+    start = bench_now_ns();
+    for (uint32_t i = 0; i < iterations; i++) {
+        uint32_t addr = 0;
+        uint32_t cmd = 0;
+        bool repeat = false;
+        s_sink += parser->get_scan_code(parser, &addr, &cmd, &repeat);
+    }
+    bench_report("get_scan_code_bad", iterations, bench_now_ns() - start);
+
+    // Stream mode: each frame fed in chunks of BENCH_STREAM_CHUNK items, then drained
+    ir_parser_config_t stream_config = parser_config;
+    stream_config.flags |= IR_TOOLS_FLAGS_STREAM;
+    ir_parser_t *stream_parser = ir_parser_rmt_new_samsung(&stream_config);
+    start = bench_now_ns();
+    for (uint32_t i = 0; i < iterations; i++) {
+        for (uint32_t offset = 0; offset < BENCH_RX_FRAME_ITEMS; offset += BENCH_STREAM_CHUNK) {
+            uint32_t chunk = BENCH_RX_FRAME_ITEMS - offset < BENCH_STREAM_CHUNK ? BENCH_RX_FRAME_ITEMS - offset : BENCH_STREAM_CHUNK;
+            stream_parser->input(stream_parser, &rx_frames[i & 1][offset], chunk);
+        }
+        uint32_t addr = 0;
+        uint32_t cmd = 0;
+        bool repeat = false;
+        while (stream_parser->get_scan_code(stream_parser, &addr, &cmd, &repeat) == ESP_OK) {
+            s_sink += cmd;
+        }
+    }
+    bench_report("stream_decode", iterations, bench_now_ns() - start);
+    stream_parser->del(stream_parser);
+
+    // Burst of frames delivered as one buffer, separated by the repeat gap
+    rmt_item32_t burst[BENCH_BURST_FRAMES * BENCH_RX_FRAME_ITEMS];
+    for (int f = 0; f < BENCH_BURST_FRAMES; f++) {
+        memcpy(&burst[f * BENCH_RX_FRAME_ITEMS], rx_frames[f & 1], sizeof(rx_frames[0]));
+        burst[(f + 1) * BENCH_RX_FRAME_ITEMS - 1].duration1 = f == BENCH_BURST_FRAMES - 1 ? 0 : 5500;
+    }
+    ir_scan_code_t codes[BENCH_BURST_FRAMES];
+    uint32_t num_codes = 0;
+    ESP_ERROR_CHECK(parser->decode_batch(parser, burst, BENCH_BURST_FRAMES * BENCH_RX_FRAME_ITEMS, codes, BENCH_BURST_FRAMES, &num_codes));
+    if (num_codes != BENCH_BURST_FRAMES) {
+        fprintf(stderr, "batch decoded %u of %d frames\n", num_codes, BENCH_BURST_FRAMES);
+        return EXIT_FAILURE;
+    }
+    start = bench_now_ns();
+    for (uint32_t i = 0; i < iterations / BENCH_BURST_FRAMES; i++) {
+        parser->decode_batch(parser, burst, BENCH_BURST_FRAMES * BENCH_RX_FRAME_ITEMS, codes, BENCH_BURST_FRAMES, &num_codes);
+        s_sink += num_codes;
+    }
+    bench_report("decode_batch", iterations / BENCH_BURST_FRAMES * BENCH_BURST_FRAMES, bench_now_ns() - start);
+
+    // Same burst learning the timing of every decoded frame
+    ir_parser_config_t calibrate_config = parser_config;
+    calibrate_config.flags |= IR_TOOLS_FLAGS_CALIBRATE;
+    ir_parser_t *calibrate_parser = ir_parser_rmt_new_samsung(&calibrate_config);
+    start = bench_now_ns();
+    for (uint32_t i = 0; i < iterations / BENCH_BURST_FRAMES; i++) {
+        calibrate_parser->decode_batch(calibrate_parser, burst, BENCH_BURST_FRAMES * BENCH_RX_FRAME_ITEMS, codes,
+                                       BENCH_BURST_FRAMES, &num_codes);
+        s_sink += num_codes;
+    }
+    bench_report("decode_calibrate", iterations / BENCH_BURST_FRAMES * BENCH_BURST_FRAMES, bench_now_ns() - start);
+    if (num_codes != BENCH_BURST_FRAMES) {
+        fprintf(stderr, "calibrated batch decoded %u of %d frames\n", num_codes, BENCH_BURST_FRAMES);
+        return EXIT_FAILURE;
+    }
+    calibrate_parser->del(calibrate_parser);
+
+    // Same burst received with marks 250 us short and spaces 250 us long, beyond the 200 us margin: the plain
+    // parser loses every frame, a new calibrating one learns from the first near miss and decodes the rest
+    uint32_t counter_clk_hz = 0;
+    ESP_ERROR_CHECK(rmt_get_counter_clock(RMT_CHANNEL_1, &counter_clk_hz));
+    uint32_t skew_ticks = 250 * (counter_clk_hz / 1000000);
+    rmt_item32_t skewed[BENCH_BURST_FRAMES * BENCH_RX_FRAME_ITEMS];
+    for (int i = 0; i < BENCH_BURST_FRAMES * BENCH_RX_FRAME_ITEMS; i++) {
+        skewed[i] = burst[i];
+        skewed[i].duration0 -= skew_ticks;
+        skewed[i].duration1 += skewed[i].duration1 ? skew_ticks : 0;
+    }
+    uint32_t skewed_codes[2] = {0};
+    ESP_ERROR_CHECK(parser->decode_batch(parser, skewed, BENCH_BURST_FRAMES * BENCH_RX_FRAME_ITEMS, codes, BENCH_BURST_FRAMES,
+                                         &num_codes));
+    calibrate_parser = ir_parser_rmt_new_samsung(&calibrate_config);
+    for (int pass = 0; pass < 2; pass++) {
+        ESP_ERROR_CHECK(calibrate_parser->decode_batch(calibrate_parser, skewed, BENCH_BURST_FRAMES * BENCH_RX_FRAME_ITEMS,
+                                                       codes, BENCH_BURST_FRAMES, &skewed_codes[pass]));
+    }
+    ir_parser_calibration_t calibration;
+    ESP_ERROR_CHECK(ir_parser_rmt_get_calibration(calibrate_parser, &calibration));
+    printf("skewed burst: %u of %d frames decoded, calibrating %u then %u, bit mark offset %d us\n", num_codes,
+           BENCH_BURST_FRAMES, skewed_codes[0], skewed_codes[1], calibration.bit_mark.offset_us);
+    if (num_codes || skewed_codes[0] != BENCH_BURST_FRAMES - 1 || skewed_codes[1] != BENCH_BURST_FRAMES ||
+            calibration.address != BENCH_ADDRESS) {
+        fprintf(stderr, "calibration did not learn the skewed timing\n");
+        return EXIT_FAILURE;
+    }
+    // A second remote skewed the other way, interleaved with the first: no single timing decodes both, each
+    // remote gets its own calibration
+    rmt_item32_t *other_items = NULL;
+    size_t other_length = 0;
+    rmt_item32_t pair[2 * BENCH_RX_FRAME_ITEMS];
+    ESP_ERROR_CHECK(builder->build_frame(builder, BENCH_ADDRESS + 1, s_commands[0]));
+    ESP_ERROR_CHECK(builder->get_result(builder, &other_items, &other_length));
+    memcpy(pair, skewed, sizeof(skewed[0]) * BENCH_RX_FRAME_ITEMS);
+    pair[BENCH_RX_FRAME_ITEMS - 1].duration1 = 5500;
+    bench_loopback(other_items, &pair[BENCH_RX_FRAME_ITEMS], BENCH_RX_FRAME_ITEMS);
+    for (int i = BENCH_RX_FRAME_ITEMS; i < 2 * BENCH_RX_FRAME_ITEMS; i++) {
+        pair[i].duration0 += skew_ticks;
+        pair[i].duration1 -= pair[i].duration1 ? skew_ticks : 0;
+    }
+    for (int pass = 0; pass < 16; pass++) {
+        ESP_ERROR_CHECK(calibrate_parser->decode_batch(calibrate_parser, pair, 2 * BENCH_RX_FRAME_ITEMS, codes,
+                                                       BENCH_BURST_FRAMES, &num_codes));
+    }
+    if (num_codes != 2 || codes[0].address != BENCH_ADDRESS || codes[1].address != BENCH_ADDRESS + 1) {
+        fprintf(stderr, "calibration of two remotes decoded %u of 2 frames\n", num_codes);
+        return EXIT_FAILURE;
+    }
+    calibrate_parser->del(calibrate_parser);
+
+    // Same burst through a dispatcher that also knows NEC: only the Samsung parser should run
+    static const ir_protocol_t *const protocols[] = {&ir_protocol_nec, &ir_protocol_samsung};
+    ir_parser_t *dispatch_parser = ir_parser_rmt_new_dispatch(&parser_config, protocols, sizeof(protocols) / sizeof(protocols[0]));
+    ESP_ERROR_CHECK(dispatch_parser->decode_batch(dispatch_parser, burst, BENCH_BURST_FRAMES * BENCH_RX_FRAME_ITEMS, codes,
+                                                  BENCH_BURST_FRAMES, &num_codes));
+    if (num_codes != BENCH_BURST_FRAMES || codes[0].protocol != &ir_protocol_samsung) {
+        fprintf(stderr, "dispatch decoded %u of %d frames\n", num_codes, BENCH_BURST_FRAMES);
+        return EXIT_FAILURE;
+    }
+    start = bench_now_ns();
+    for (uint32_t i = 0; i < iterations / BENCH_BURST_FRAMES; i++) {
+        dispatch_parser->decode_batch(dispatch_parser, burst, BENCH_BURST_FRAMES * BENCH_RX_FRAME_ITEMS, codes, BENCH_BURST_FRAMES, &num_codes);
+        s_sink += num_codes;
+    }
+    bench_report("dispatch_batch", iterations / BENCH_BURST_FRAMES * BENCH_BURST_FRAMES, bench_now_ns() - start);
+    // An NEC frame cut short must not hide the leading code of the Samsung frame right after it
+    rmt_item32_t cut[10 + BENCH_RX_FRAME_ITEMS];
+    ir_builder_t *nec_builder = ir_builder_rmt_new(&builder_config, &ir_protocol_nec);
+    rmt_item32_t *nec_items = NULL;
+    size_t nec_length = 0;
+    ESP_ERROR_CHECK(nec_builder->build_frame(nec_builder, BENCH_ADDRESS, s_commands[0]));
+    ESP_ERROR_CHECK(nec_builder->get_result(nec_builder, &nec_items, &nec_length));
+    bench_loopback(nec_items, cut, 10);
+    nec_builder->del(nec_builder);
+    memcpy(&cut[10], rx_frames[1], sizeof(rx_frames[1]));
+    ir_parser_stats_t before;
+    ir_parser_stats_t after;
+    ESP_ERROR_CHECK(ir_parser_rmt_get_stats(dispatch_parser, &before));
+    ESP_ERROR_CHECK(dispatch_parser->decode_batch(dispatch_parser, cut, sizeof(cut) / sizeof(cut[0]), codes,
+                                                  BENCH_BURST_FRAMES, &num_codes));
+    if (num_codes != 1 || codes[0].command != s_commands[1]) {
+        fprintf(stderr, "dispatch lost the frame after a truncated one\n");
+        return EXIT_FAILURE;
+    }
+    // The statistics of a dispatch parser sum its protocols: one frame decoded, the truncated one rejected
+    ESP_ERROR_CHECK(ir_parser_rmt_get_stats(dispatch_parser, &after));
+    uint32_t rejected = (after.head_level + after.head_mark + after.head_space + after.bit_timing + after.length + after.trailer) -
+                        (before.head_level + before.head_mark + before.head_space + before.bit_timing + before.length + before.trailer);
+    if (after.frames - before.frames != 1 || rejected != 1) {
+        fprintf(stderr, "dispatch stats: %u frames decoded, %u rejected\n", after.frames - before.frames, rejected);
+        return EXIT_FAILURE;
+    }
+    dispatch_parser->del(dispatch_parser);
+
+    // Same again in static storage, then recreated in place with another margin as on reconfiguration
+    static IR_TOOLS_STATIC_STORAGE(dispatch_storage, IR_PARSER_DISPATCH_STATIC_SIZE(2));
+    dispatch_parser = ir_parser_rmt_new_dispatch_static(&parser_config, protocols, 2, dispatch_storage, sizeof(dispatch_storage));
+    if (!dispatch_parser || ir_parser_rmt_new_dispatch_static(&parser_config, protocols, 2, dispatch_storage,
+                                                              IR_PARSER_DISPATCH_STATIC_SIZE(2) - 1)) {
+        fprintf(stderr, "static dispatch parser: unexpected storage check\n");
+        return EXIT_FAILURE;
+    }
+    ESP_ERROR_CHECK(dispatch_parser->decode_batch(dispatch_parser, burst, BENCH_BURST_FRAMES * BENCH_RX_FRAME_ITEMS, codes,
+                                                  BENCH_BURST_FRAMES, &num_codes));
+    if (num_codes != BENCH_BURST_FRAMES || codes[0].protocol != &ir_protocol_samsung) {
+        fprintf(stderr, "static dispatch decoded %u of %d frames\n", num_codes, BENCH_BURST_FRAMES);
+        return EXIT_FAILURE;
+    }
+    ir_parser_config_t recreate_config = parser_config;
+    start = bench_now_ns();
+    for (uint32_t i = 0; i < iterations; i++) {
+        dispatch_parser->del(dispatch_parser);
+        recreate_config.margin_us = 150 + (i & 63);
+        dispatch_parser = ir_parser_rmt_new_dispatch_static(&recreate_config, protocols, 2, dispatch_storage, sizeof(dispatch_storage));
+    }
+    bench_report("parser_recreate", iterations, bench_now_ns() - start);
+    dispatch_parser->del(dispatch_parser);
+
+    // A builder in static storage builds the same frames as one on the heap
+    static IR_TOOLS_STATIC_STORAGE(builder_storage, IR_BUILDER_RMT_STATIC_SIZE(128));
+    ir_builder_t *static_builder = ir_builder_rmt_new_static(&builder_config, &ir_protocol_samsung, builder_storage,
+                                                             sizeof(builder_storage));
+    if (!static_builder) {
+        fprintf(stderr, "static builder: creation failed\n");
+        return EXIT_FAILURE;
+    }
+    for (int i = 0; i < 2; i++) {
+        rmt_item32_t *items = NULL;
+        rmt_item32_t *static_items = NULL;
+        size_t length = 0;
+        size_t static_length = 0;
+        ESP_ERROR_CHECK(builder->build_frame(builder, BENCH_ADDRESS, s_commands[i]));
+        ESP_ERROR_CHECK(builder->get_result(builder, &items, &length));
+        ESP_ERROR_CHECK(static_builder->build_frame(static_builder, BENCH_ADDRESS, s_commands[i]));
+        ESP_ERROR_CHECK(static_builder->get_result(static_builder, &static_items, &static_length));
+        if (static_length != length || memcmp(static_items, items, length * sizeof(rmt_item32_t))) {
+            fprintf(stderr, "static builder: frame %d differs\n", i);
+            return EXIT_FAILURE;
+        }
+    }
+    static_builder->del(static_builder);
+
+    start = bench_now_ns();
+    for (uint32_t i = 0; i < iterations; i++) {
+        rmt_item32_t *items = NULL;
+        size_t length = 0;
+        uint32_t addr = 0;
+        uint32_t cmd = 0;
+        bool repeat = false;
+        builder->build_frame(builder, BENCH_ADDRESS, s_commands[i & 1]);
+        builder->get_result(builder, &items, &length);
+        parser->input(parser, rx_frames[i & 1], BENCH_RX_FRAME_ITEMS);
+        parser->get_scan_code(parser, &addr, &cmd, &repeat);
+        s_sink += cmd;
+    }
+    bench_report("round_trip", iterations, bench_now_ns() - start);
+
+    // RX recorder: one record per received frame, read back in full
+    static uint32_t capture_buffer[(sizeof(ir_capture_header_t) + 64 * (sizeof(ir_capture_record_t) + sizeof(rx_frames[0]))) / 4];
+    ir_capture_writer_t capture_writer;
+    start = bench_now_ns();
+    for (uint32_t i = 0; i < iterations; i++) {
+        if (!(i & 63)) {
+            ir_capture_writer_init(&capture_writer, capture_buffer, sizeof(capture_buffer), 1000000);
+        }
+        s_sink += ir_capture_write(&capture_writer, i, rx_frames[i & 1], BENCH_RX_FRAME_ITEMS);
+    }
+    bench_report("capture_write", iterations, bench_now_ns() - start);
+    ir_capture_writer_init(&capture_writer, capture_buffer, sizeof(capture_buffer), 1000000);
+    for (uint32_t i = 0; i < 64; i++) {
+        ir_capture_write(&capture_writer, i * 100000, rx_frames[i & 1], BENCH_RX_FRAME_ITEMS);
+    }
+    ir_capture_reader_t capture_reader;
+    uint32_t records = 0;
+    start = bench_now_ns();
+    for (uint32_t i = 0; i < iterations / 64; i++) {
+        int64_t timestamp_us = 0;
+        const rmt_item32_t *items = NULL;
+        uint32_t num_items = 0;
+        ir_capture_reader_init(&capture_reader, capture_buffer, capture_writer.length);
+        for (records = 0; ir_capture_read(&capture_reader, &timestamp_us, &items, &num_items) == ESP_OK; records++) {
+            if (num_items != BENCH_RX_FRAME_ITEMS || timestamp_us != records * 100000 ||
+                    memcmp(items, rx_frames[records & 1], sizeof(rx_frames[0]))) {
+                fprintf(stderr, "capture record %u differs\n", records);
+                return EXIT_FAILURE;
+            }
+        }
+    }
+    bench_report("capture_read", iterations / 64 * 64, bench_now_ns() - start);
+    if (iterations >= 64 && records != 64) {
+        fprintf(stderr, "capture read %u of 64 records\n", records);
+        return EXIT_FAILURE;
+    }
+
+    // Clean frames only pay for the scan, nothing is written
+    start = bench_now_ns();
+    for (uint32_t i = 0; i < iterations; i++) {
+        size_t num_items = BENCH_RX_FRAME_ITEMS;
+        ir_filter_glitches(rx_frames[i & 1], &num_items, 2 * BENCH_GLITCH_TICKS, NULL);
+        s_sink += num_items;
+    }
+    bench_report("filter_clean", iterations, bench_now_ns() - start);
+
+    // Two glitches split a bit mark and a bit space of the frame, each adding an item; the filter must restore it
+    uint32_t levels[2 * BENCH_RX_FRAME_ITEMS + 4];
+    uint32_t durations[2 * BENCH_RX_FRAME_ITEMS + 4];
+    uint32_t num_levels = 0;
+    for (uint32_t i = 0; i < 2 * BENCH_RX_FRAME_ITEMS - 1; i++) {
+        const rmt_item32_t *item = &rx_frames[0][i / 2];
+        levels[num_levels] = (i & 1) ? item->level1 : item->level0;
+        durations[num_levels] = (i & 1) ? item->duration1 : item->duration0;
+        if (i == 20 || i == 41) {
+            uint32_t before = durations[num_levels] / 3;
+            levels[num_levels + 1] = !levels[num_levels];
+            durations[num_levels + 1] = BENCH_GLITCH_TICKS;
+            levels[num_levels + 2] = levels[num_levels];
+            durations[num_levels + 2] = durations[num_levels] - before - BENCH_GLITCH_TICKS;
+            durations[num_levels] = before;
+            num_levels += 2;
+        }
+        num_levels++;
+    }
+    rmt_item32_t glitched[BENCH_RX_FRAME_ITEMS + 2] = {0};
+    for (uint32_t i = 0; i < num_levels; i++) {
+        if (i & 1) {
+            glitched[i / 2].level1 = levels[i];
+            glitched[i / 2].duration1 = durations[i];
+        } else {
+            glitched[i / 2].level0 = levels[i];
+            glitched[i / 2].duration0 = durations[i];
+        }
+    }
+    glitched[num_levels / 2].level1 = !levels[num_levels - 1];
+    rmt_item32_t filtered[BENCH_RX_FRAME_ITEMS + 2];
+    size_t num_filtered = 0;
+    start = bench_now_ns();
+    for (uint32_t i = 0; i < iterations; i++) {
+        memcpy(filtered, glitched, sizeof(glitched));
+        num_filtered = (num_levels + 1) / 2;
+        ir_filter_glitches(filtered, &num_filtered, 2 * BENCH_GLITCH_TICKS, NULL);
+        s_sink += num_filtered;
+    }
+    bench_report("filter_glitches", iterations, bench_now_ns() - start);
+    if (num_filtered != BENCH_RX_FRAME_ITEMS || memcmp(filtered, rx_frames[0], sizeof(rx_frames[0]))) {
+        fprintf(stderr, "glitch filter left %u items\n", (unsigned)num_filtered);
+        return EXIT_FAILURE;
+    }
+
+    // Latency histogram on a pinned cycle counter: 90% at 5 us, 9% at 100 us, 1% at 3 ms
+    ir_latency_hist_t latency;
+    ir_latency_init(&latency);
+    for (uint32_t i = 0; i < 1000; i++) {
+        uint32_t us = i < 900 ? 5 : i < 990 ? 100 : 3000;
+        esp_cpu_mock_set_ccount(true, 0xFFFFF000 + i); // samples across the counter wrap
+        uint32_t start = ir_latency_now();
+        esp_cpu_mock_set_ccount(true, start + us * latency.cycles_per_us);
+        ir_latency_since(&latency, start);
+    }
+    esp_cpu_mock_set_ccount(false, 0);
+    uint32_t p50 = 0;
+    uint32_t p90 = 0;
+    uint32_t p99 = 0;
+    uint32_t p100 = 0;
+    ir_latency_get_percentile(&latency, 50, &p50);
+    ir_latency_get_percentile(&latency, 90, &p90);
+    ir_latency_get_percentile(&latency, 99, &p99);
+    ir_latency_get_percentile(&latency, 100, &p100);
+    if (latency.count != 1000 || p50 < 5 || p50 > 10 || p90 != p50 || p99 < 100 || p99 > 200 || p100 != 3000) {
+        fprintf(stderr, "latency percentiles %u/%u/%u/%u us\n", p50, p90, p99, p100);
+        return EXIT_FAILURE;
+    }
+    start = bench_now_ns();
+    for (uint32_t i = 0; i < iterations; i++) {
+        ir_latency_since(&latency, ir_latency_now());
+    }
+    bench_report("latency_record", iterations, bench_now_ns() - start);
+
+    // Event trace: a full ring keeps its oldest events in order and counts the rest as dropped
+    static ir_trace_slot_t trace_slots[64];
+    ir_trace_t trace;
+    ir_trace_record_t trace_record;
+    ESP_ERROR_CHECK(ir_trace_init(&trace, trace_slots, 64));
+    for (uint32_t i = 0; i < 70; i++) {
+        ir_trace_record(&trace, IR_TRACE_DECODE_OK, i & 3, i);
+    }
+    for (uint32_t i = 0; i < 64; i++) {
+        if (ir_trace_read(&trace, &trace_record) != ESP_OK || trace_record.payload != i || trace_record.channel != (i & 3) ||
+                trace_record.event != IR_TRACE_DECODE_OK) {
+            fprintf(stderr, "trace: event %u lost\n", i);
+            return EXIT_FAILURE;
+        }
+    }
+    if (ir_trace_read(&trace, &trace_record) != ESP_ERR_NOT_FOUND || ir_trace_get_dropped(&trace) != 6) {
+        fprintf(stderr, "trace: %u events dropped of 6\n", ir_trace_get_dropped(&trace));
+        return EXIT_FAILURE;
+    }
+    // Recorded and drained in batches as by the drain task
+    start = bench_now_ns();
+    for (uint32_t i = 0; i < iterations; i++) {
+        ir_trace_record(&trace, IR_TRACE_TX_START, 0, i);
+        if ((i & 31) == 31) {
+            while (ir_trace_read(&trace, &trace_record) == ESP_OK) {
+                s_sink += trace_record.payload;
+            }
+        }
+    }
+    bench_report("trace_record", iterations, bench_now_ns() - start);
+
+    // Bursty control plane: 4 updates to each of 4 units per drain, only the newest state per unit is sent
+    ir_tx_queue_t tx_queue;
+    ir_tx_queue_init(&tx_queue);
+    start = bench_now_ns();
+    for (uint32_t i = 0; i < iterations; i++) {
+        ir_tx_command_t command = {
+            .unit = i & 3,
+            .address = BENCH_ADDRESS,
+            .command = i,
+            .priority = i & 1,
+        };
+        s_sink += ir_tx_queue_push(&tx_queue, &command, NULL);
+        if ((i & 15) == 15) {
+            while (ir_tx_queue_pop(&tx_queue, &command) == ESP_OK) {
+                s_sink += command.command;
+            }
+        }
+    }
+    bench_report("tx_queue_push", iterations, bench_now_ns() - start);
+    printf("tx queue: %u coalesced\n", tx_queue.coalesced);
+    // A command that could not go out stays queued; one replaced while it was being sent is not removed
+    ir_tx_queue_init(&tx_queue);
+    ir_tx_command_t older = {.unit = 1, .address = BENCH_ADDRESS, .command = 1, .channels = 1};
+    ir_tx_command_t newer = {.unit = 1, .address = BENCH_ADDRESS, .command = 2, .channels = 1};
+    ir_tx_command_t peeked;
+    ESP_ERROR_CHECK(ir_tx_queue_push(&tx_queue, &older, NULL));
+    ESP_ERROR_CHECK(ir_tx_queue_peek_ready(&tx_queue, 1, &peeked));
+    ESP_ERROR_CHECK(ir_tx_queue_push(&tx_queue, &newer, NULL));
+    if (ir_tx_queue_commit(&tx_queue, &peeked) != ESP_ERR_NOT_FOUND ||
+            ir_tx_queue_peek_ready(&tx_queue, 1, &peeked) != ESP_OK || peeked.command != newer.command ||
+            ir_tx_queue_commit(&tx_queue, &peeked) != ESP_OK || tx_queue.count) {
+        fprintf(stderr, "tx queue lost or kept the wrong command across peek and commit\n");
+        return EXIT_FAILURE;
+    }
+
+    // Aircon states to 4 units, the setpoint only changing every 8 updates: unchanged states are never queued
+    ir_tx_queue_init(&tx_queue);
+    start = bench_now_ns();
+    for (uint32_t i = 0; i < iterations; i++) {
+        ir_aircon_state_t state = {
+            .power = true,
+            .mode = IR_AIRCON_MODE_COOL,
+            .setpoint_c = IR_AIRCON_SETPOINT_MIN_C + ((i >> 5) & 7),
+            .fan = IR_AIRCON_FAN_AUTO,
+        };
+        ir_tx_command_t command = {
+            .unit = i & 3,
+            .address = BENCH_ADDRESS,
+        };
+        s_sink += ir_aircon_samsung_encode(&state, &command.command);
+        s_sink += ir_tx_queue_push_changed(&tx_queue, &command, NULL);
+        if ((i & 15) == 15) {
+            while (ir_tx_queue_pop(&tx_queue, &command) == ESP_OK) {
+                ir_tx_queue_mark_sent(&tx_queue, &command);
+            }
+        }
+    }
+    bench_report("tx_queue_push_state", iterations, bench_now_ns() - start);
+    printf("tx queue: %u states skipped\n", tx_queue.skipped);
+    ir_aircon_state_t state_in = {
+        .power = true,
+        .mode = IR_AIRCON_MODE_HEAT,
+        .setpoint_c = IR_AIRCON_SETPOINT_MAX_C,
+        .fan = IR_AIRCON_FAN_HIGH,
+        .swing = true,
+    };
+    ir_aircon_state_t state_out;
+    uint32_t state_command = 0;
+    if (ir_aircon_samsung_encode(&state_in, &state_command) != ESP_OK ||
+            ir_aircon_samsung_decode(state_command, &state_out) != ESP_OK ||
+            state_out.power != state_in.power || state_out.mode != state_in.mode ||
+            state_out.setpoint_c != state_in.setpoint_c || state_out.fan != state_in.fan ||
+            state_out.swing != state_in.swing) {
+        printf("aircon state mismatch: command 0x%08x\n", state_command);
+        return EXIT_FAILURE;
+    }
+
+    uint32_t hits = 0;
+    uint32_t misses = 0;
+    ir_builder_rmt_get_cache_stats(builder, &hits, &misses);
+    printf("frame cache: %u hits, %u misses\n", hits, misses);
+    ir_parser_stats_t stats;
+    ir_parser_rmt_get_stats(parser, &stats);
+    printf("parser: %u frames (%u repeats), rejected: head %u/%u/%u, bit timing %u, length %u, trailer %u\n",
+           stats.frames, stats.repeats, stats.head_level, stats.head_mark, stats.head_space, stats.bit_timing, stats.length,
+           stats.trailer);
+
+    parser->del(parser);
+    builder->del(builder);
+    return EXIT_SUCCESS;
+}
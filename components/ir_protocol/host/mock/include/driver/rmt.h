@@ -0,0 +1,93 @@
+// Host stand-in for the ESP-IDF RMT driver header.
+//
+// Provides the item layout and the counter clock query used by the IR
+// builders/parsers. The counter clock defaults to 1 MHz, which is what
+// RMT_DEFAULT_CONFIG_TX/RX (80 MHz APB, clk_div 80) gives on target, and can
+// be changed per channel with rmt_mock_set_counter_clock(). Sample translation
+// (rmt_write_sample) asks the translator for a 64-item block, then half blocks,
+// and stops after the first fill short of what it asked for, like the IDF 4.4
+// driver refilling channel RAM; the items can be captured with rmt_mock_set_tx_sink().
+
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "esp_err.h"
+
+typedef enum {
+    RMT_CHANNEL_0,
+    RMT_CHANNEL_1,
+    RMT_CHANNEL_2,
+    RMT_CHANNEL_3,
+    RMT_CHANNEL_4,
+    RMT_CHANNEL_5,
+    RMT_CHANNEL_6,
+    RMT_CHANNEL_7,
+    RMT_CHANNEL_MAX
+} rmt_channel_t;
+
+typedef struct {
+    union {
+        struct {
+            uint32_t duration0 : 15;
+            uint32_t level0 : 1;
+            uint32_t duration1 : 15;
+            uint32_t level1 : 1;
+        };
+        uint32_t val;
+    };
+} rmt_item32_t;
+
+typedef uint32_t TickType_t; // FreeRTOS tick type, the mock never blocks
+#define portMAX_DELAY ((TickType_t)0xffffffffUL)
+#define pdMS_TO_TICKS(ms) ((TickType_t)(ms))
+
+typedef void (*sample_to_rmt_t)(const void *src, rmt_item32_t *dest, size_t src_size, size_t wanted_num,
+                                size_t *translated_size, size_t *item_num);
+
+esp_err_t rmt_get_counter_clock(rmt_channel_t channel, uint32_t *clock_hz);
+
+esp_err_t rmt_translator_init(rmt_channel_t channel, sample_to_rmt_t fn);
+
+esp_err_t rmt_translator_set_context(rmt_channel_t channel, void *context);
+
+esp_err_t rmt_translator_get_context(const size_t *item_num, void **context);
+
+esp_err_t rmt_write_sample(rmt_channel_t channel, const uint8_t *src, size_t src_size, bool wait_tx_done);
+
+esp_err_t rmt_wait_tx_done(rmt_channel_t channel, TickType_t wait_time);
+
+/**
+ * @brief Capture the items produced by rmt_write_sample on a channel (host only)
+ *
+ * @param[in] channel: RMT channel
+ * @param[in] items: Buffer receiving the items, NULL to stop capturing
+ * @param[in] capacity: Capacity of items, extra items are counted but dropped
+ * @param[out] length: Number of items produced by the last rmt_write_sample
+ *
+ * @return
+ *      - ESP_OK: Set sink successfully
+ *      - ESP_ERR_INVALID_ARG: Invalid channel
+ */
+esp_err_t rmt_mock_set_tx_sink(rmt_channel_t channel, rmt_item32_t *items, size_t capacity, size_t *length);
+
+/**
+ * @brief Set the counter clock reported by rmt_get_counter_clock (host only)
+ *
+ * @param[in] channel: RMT channel
+ * @param[in] clock_hz: Counter clock in Hz
+ *
+ * @return
+ *      - ESP_OK: Set counter clock successfully
+ *      - ESP_ERR_INVALID_ARG: Invalid channel or zero clock
+ */
+esp_err_t rmt_mock_set_counter_clock(rmt_channel_t channel, uint32_t clock_hz);
+
+#ifdef __cplusplus
+}
+#endif
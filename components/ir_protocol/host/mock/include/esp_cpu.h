@@ -0,0 +1,27 @@
+// Host stand-in for the CPU cycle counter of esp_cpu.h.
+//
+// One cycle is one nanosecond of the host monotonic clock (see esp_rom_get_cpu_ticks_per_us),
+// unless a test pins the counter with esp_cpu_mock_set_ccount().
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+uint32_t esp_cpu_get_ccount(void);
+
+/**
+ * @brief Make esp_cpu_get_ccount return a fixed count, e.g. to step latencies exactly (host only)
+ *
+ * @param[in] enable: false to return to the host monotonic clock
+ * @param[in] ccount: Count returned by esp_cpu_get_ccount
+ */
+void esp_cpu_mock_set_ccount(bool enable, uint32_t ccount);
+
+#ifdef __cplusplus
+}
+#endif
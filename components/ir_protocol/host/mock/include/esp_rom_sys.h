@@ -0,0 +1,21 @@
+// Host stand-in for the subset of esp_rom_sys.h used by ir_protocol.
+
+#pragma once
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief CPU cycles per microsecond: the mock cycle counter counts nanoseconds
+ */
+static inline uint32_t esp_rom_get_cpu_ticks_per_us(void)
+{
+    return 1000;
+}
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,26 @@
+// Host stand-in for the subset of the ESP-IDF high resolution timer used by ir_protocol.
+//
+// Time is the host monotonic clock, unless a replay pins it with esp_timer_mock_set_time().
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+int64_t esp_timer_get_time(void);
+
+/**
+ * @brief Make esp_timer_get_time return a fixed time, e.g. the timestamp of a replayed capture (host only)
+ *
+ * @param[in] enable: false to return to the host monotonic clock
+ * @param[in] time_us: Time returned by esp_timer_get_time
+ */
+void esp_timer_mock_set_time(bool enable, int64_t time_us);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,15 @@
+// Force-included into every host translation unit.
+//
+// newlib's <sys/cdefs.h> provides __containerof on target; glibc does not.
+
+#pragma once
+
+#include <stddef.h>
+
+#ifndef __containerof
+#define __containerof(ptr, type, member) ((type *)((char *)(ptr) - offsetof(type, member)))
+#endif
+
+#ifndef __unused
+#define __unused __attribute__((__unused__))
+#endif
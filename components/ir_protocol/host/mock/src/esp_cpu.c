@@ -0,0 +1,23 @@
+// Host stand-in for the CPU cycle counter.
+
+#include <time.h>
+#include "esp_cpu.h"
+
+static bool s_fixed;
+static uint32_t s_fixed_ccount;
+
+uint32_t esp_cpu_get_ccount(void)
+{
+    if (s_fixed) {
+        return s_fixed_ccount;
+    }
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t)((uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec);
+}
+
+void esp_cpu_mock_set_ccount(bool enable, uint32_t ccount)
+{
+    s_fixed = enable;
+    s_fixed_ccount = ccount;
+}
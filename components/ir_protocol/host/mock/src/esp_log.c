@@ -0,0 +1,33 @@
+// Host stand-in for the ESP-IDF logging library.
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <time.h>
+#include "esp_log.h"
+
+static esp_log_level_t s_log_level = ESP_LOG_INFO;
+
+void esp_log_level_set(const char *tag, esp_log_level_t level)
+{
+    (void)tag;
+    s_log_level = level;
+}
+
+uint32_t esp_log_timestamp(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t)(ts.tv_sec * 1000 + ts.tv_nsec / 1000000);
+}
+
+void esp_log_write(esp_log_level_t level, const char *tag, const char *format, ...)
+{
+    (void)tag;
+    if (level > s_log_level) {
+        return;
+    }
+    va_list args;
+    va_start(args, format);
+    vfprintf(stderr, format, args);
+    va_end(args);
+}
@@ -0,0 +1,23 @@
+// Host stand-in for the ESP-IDF high resolution timer.
+
+#include <time.h>
+#include "esp_timer.h"
+
+static bool s_fixed;
+static int64_t s_fixed_us;
+
+int64_t esp_timer_get_time(void)
+{
+    if (s_fixed) {
+        return s_fixed_us;
+    }
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+void esp_timer_mock_set_time(bool enable, int64_t time_us)
+{
+    s_fixed = enable;
+    s_fixed_us = time_us;
+}
@@ -0,0 +1,116 @@
+// Host stand-in for the ESP-IDF RMT driver.
+
+#include "driver/rmt.h"
+
+
+#define RMT_MOCK_DEFAULT_COUNTER_CLK_HZ (1000000)
+#define RMT_MOCK_MEM_ITEM_NUM (64)
+
+typedef struct {
+    sample_to_rmt_t translator;
+    void *context;
+    size_t item_num;               // its address identifies the channel in rmt_translator_get_context
+    rmt_item32_t *sink;
+    size_t sink_capacity;
+    size_t *sink_length;
+} rmt_mock_channel_t;
+
+static uint32_t s_counter_clk_hz[RMT_CHANNEL_MAX];
+static rmt_mock_channel_t s_channels[RMT_CHANNEL_MAX];
+
+esp_err_t rmt_get_counter_clock(rmt_channel_t channel, uint32_t *clock_hz)
+{
+    if (channel >= RMT_CHANNEL_MAX || !clock_hz) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    *clock_hz = s_counter_clk_hz[channel] ? s_counter_clk_hz[channel] : RMT_MOCK_DEFAULT_COUNTER_CLK_HZ;
+    return ESP_OK;
+}
+
+esp_err_t rmt_mock_set_counter_clock(rmt_channel_t channel, uint32_t clock_hz)
+{
+    if (channel >= RMT_CHANNEL_MAX || !clock_hz) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    s_counter_clk_hz[channel] = clock_hz;
+    return ESP_OK;
+}
+
+esp_err_t rmt_translator_init(rmt_channel_t channel, sample_to_rmt_t fn)
+{
+    if (channel >= RMT_CHANNEL_MAX || !fn) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    s_channels[channel].translator = fn;
+    return ESP_OK;
+}
+
+esp_err_t rmt_translator_set_context(rmt_channel_t channel, void *context)
+{
+    if (channel >= RMT_CHANNEL_MAX) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    s_channels[channel].context = context;
+    return ESP_OK;
+}
+
+esp_err_t rmt_translator_get_context(const size_t *item_num, void **context)
+{
+    for (int i = 0; i < RMT_CHANNEL_MAX; i++) {
+        if (item_num == &s_channels[i].item_num) {
+            *context = s_channels[i].context;
+            return ESP_OK;
+        }
+    }
+    return ESP_ERR_INVALID_ARG;
+}
+
+// Like the IDF 4.4 driver: the first fill asks for a whole block, each refill for half of it, and a fill of
+// fewer items than asked ends the transmission, whatever is left of the source
+esp_err_t rmt_write_sample(rmt_channel_t channel, const uint8_t *src, size_t src_size, bool wait_tx_done)
+{
+    if (channel >= RMT_CHANNEL_MAX || !src || !s_channels[channel].translator) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    rmt_mock_channel_t *mock = &s_channels[channel];
+    rmt_item32_t block[RMT_MOCK_MEM_ITEM_NUM];
+    size_t produced = 0;
+    size_t wanted = RMT_MOCK_MEM_ITEM_NUM;
+    do {
+        size_t translated = 0;
+        mock->item_num = 0;
+        mock->translator(src, block, src_size, wanted, &translated, &mock->item_num);
+        for (size_t i = 0; i < mock->item_num; i++, produced++) {
+            if (mock->sink && produced < mock->sink_capacity) {
+                mock->sink[produced] = block[i];
+            }
+        }
+        src += translated;
+        src_size -= translated;
+        if (mock->item_num < wanted) {
+            break;
+        }
+        wanted = RMT_MOCK_MEM_ITEM_NUM / 2;
+    } while (src_size);
+    if (mock->sink_length) {
+        *mock->sink_length = produced;
+    }
+    return ESP_OK;
+}
+
+esp_err_t rmt_wait_tx_done(rmt_channel_t channel, TickType_t wait_time)
+{
+    (void)wait_time;
+    return channel < RMT_CHANNEL_MAX ? ESP_OK : ESP_ERR_INVALID_ARG;
+}
+
+esp_err_t rmt_mock_set_tx_sink(rmt_channel_t channel, rmt_item32_t *items, size_t capacity, size_t *length)
+{
+    if (channel >= RMT_CHANNEL_MAX) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    s_channels[channel].sink = items;
+    s_channels[channel].sink_capacity = capacity;
+    s_channels[channel].sink_length = length;
+    return ESP_OK;
+}
@@ -0,0 +1,250 @@
+// Replay an RMT capture (see ir_capture.h) through an IR parser at full speed.
+//
+// Usage: ir_replay [-p samsung|nec|all] [-m margin_us] [-r repeat_window_ms] [-c] [-b] [-l loops] [-v] capture.bin
+//
+// Each record is handed to decode_batch the way ir_rx_task hands it a ring
+// buffer item: by default in stream mode through a dispatcher of every known
+// protocol. esp_timer_get_time follows the recorded timestamps, so repeat
+// detection sees the field timing. Reports the decode rate, the rejections by
+// reason and the latency percentiles of decode_batch per record.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "driver/rmt.h"
+#include "ir_tools.h"
+#include "ir_capture.h"
+
+#define REPLAY_CHANNEL (RMT_CHANNEL_0)
+#define REPLAY_MAX_CODES (64)
+#define REPLAY_LOOP_GAP_US (1000000) // between loops, so repeats never span two of them
+
+static const ir_protocol_t *const s_protocols[] = {&ir_protocol_samsung, &ir_protocol_nec};
+#define REPLAY_NUM_PROTOCOLS (sizeof(s_protocols) / sizeof(s_protocols[0]))
+
+static uint64_t replay_now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static int replay_compare_u64(const void *a, const void *b)
+{
+    uint64_t x = *(const uint64_t *)a;
+    uint64_t y = *(const uint64_t *)b;
+    return x < y ? -1 : x > y;
+}
+
+static uint64_t replay_percentile(const uint64_t *sorted, size_t count, unsigned percent)
+{
+    return count ? sorted[(count - 1) * percent / 100] : 0;
+}
+
+static void *replay_load(const char *path, size_t *size)
+{
+    FILE *file = fopen(path, "rb");
+    if (!file) {
+        return NULL;
+    }
+    fseek(file, 0, SEEK_END);
+    long length = ftell(file);
+    fseek(file, 0, SEEK_SET);
+    void *data = length > 0 ? malloc(length) : NULL;
+    if (data && fread(data, 1, length, file) != (size_t)length) {
+        free(data);
+        data = NULL;
+    }
+    fclose(file);
+    *size = length > 0 ? (size_t)length : 0;
+    return data;
+}
+
+static void replay_usage(const char *name)
+{
+    fprintf(stderr, "usage: %s [-p samsung|nec|all] [-m margin_us] [-r repeat_window_ms] [-c] [-b] [-l loops] [-v] capture.bin\n"
+            "  -p  protocol to decode, default all through a dispatcher\n"
+            "  -m  parser margin, default 200 us\n"
+            "  -r  repeat window, default 0 (off)\n"
+            "  -c  learn the timing calibration (IR_TOOLS_FLAGS_CALIBRATE)\n"
+            "  -b  decode each record on its own instead of as a stream\n"
+            "  -l  replay the capture this many times\n"
+            "  -v  print every scan code\n", name);
+}
+
+int main(int argc, char **argv)
+{
+    const char *protocol_name = "all";
+    ir_parser_config_t config = IR_PARSER_DEFAULT_CONFIG((ir_dev_t)REPLAY_CHANNEL);
+    config.flags |= IR_TOOLS_FLAGS_PROTO_EXT | IR_TOOLS_FLAGS_STREAM;
+    uint32_t loops = 1;
+    bool verbose = false;
+    int opt;
+    while ((opt = getopt(argc, argv, "p:m:r:cbl:v")) != -1) {
+        switch (opt) {
+        case 'p':
+            protocol_name = optarg;
+            break;
+        case 'm':
+            config.margin_us = strtoul(optarg, NULL, 0);
+            break;
+        case 'r':
+            config.repeat_window_ms = strtoul(optarg, NULL, 0);
+            break;
+        case 'c':
+            config.flags |= IR_TOOLS_FLAGS_CALIBRATE;
+            break;
+        case 'b':
+            config.flags &= ~IR_TOOLS_FLAGS_STREAM;
+            break;
+        case 'l':
+            loops = strtoul(optarg, NULL, 0);
+            break;
+        case 'v':
+            verbose = true;
+            break;
+        default:
+            replay_usage(argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+    if (optind != argc - 1 || !loops) {
+        replay_usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+    esp_log_level_set("*", ESP_LOG_NONE);
+
+    size_t size = 0;
+    void *data = replay_load(argv[optind], &size);
+    ir_capture_reader_t reader;
+    if (!data || ir_capture_reader_init(&reader, data, size) != ESP_OK) {
+        fprintf(stderr, "%s: not a readable capture\n", argv[optind]);
+        return EXIT_FAILURE;
+    }
+    rmt_mock_set_counter_clock(REPLAY_CHANNEL, reader.header.counter_clk_hz);
+
+    // One RMT parser per protocol, behind a dispatcher unless a single protocol was asked for
+    ir_parser_t *parser = NULL;
+    ir_parser_t *protocol_parsers[REPLAY_NUM_PROTOCOLS] = {0};
+    const ir_protocol_t *parser_protocols[REPLAY_NUM_PROTOCOLS] = {0};
+    uint32_t num_parsers = 0;
+    if (!strcmp(protocol_name, "all")) {
+        parser = ir_parser_rmt_new_dispatch(&config, s_protocols, REPLAY_NUM_PROTOCOLS);
+        for (num_parsers = 0; parser && num_parsers < REPLAY_NUM_PROTOCOLS; num_parsers++) {
+            ir_parser_dispatch_get_parser(parser, num_parsers, &protocol_parsers[num_parsers]);
+            parser_protocols[num_parsers] = s_protocols[num_parsers];
+        }
+    } else {
+        for (uint32_t i = 0; i < REPLAY_NUM_PROTOCOLS; i++) {
+            if (!strcmp(protocol_name, s_protocols[i]->name)) {
+                parser = ir_parser_rmt_new(&config, s_protocols[i]);
+                parser_protocols[num_parsers] = s_protocols[i];
+                protocol_parsers[num_parsers++] = parser;
+            }
+        }
+    }
+    if (!parser) {
+        fprintf(stderr, "can't create a parser for protocol %s\n", protocol_name);
+        return EXIT_FAILURE;
+    }
+
+    size_t num_latencies = (size_t)reader.header.records * loops;
+    uint64_t *latencies = malloc((num_latencies ? num_latencies : 1) * sizeof(uint64_t));
+    if (!latencies) {
+        fprintf(stderr, "out of memory\n");
+        return EXIT_FAILURE;
+    }
+    ir_scan_code_t codes[REPLAY_MAX_CODES];
+    uint64_t items_total = 0;
+    uint64_t codes_total = 0;
+    uint64_t repeats_total = 0;
+    uint64_t busy_ns = 0;
+    int64_t span_us = 0;
+    size_t record = 0;
+    for (uint32_t loop = 0; loop < loops; loop++) {
+        int64_t base_us = loop * (span_us + REPLAY_LOOP_GAP_US);
+        ir_capture_reader_init(&reader, data, size);
+        int64_t timestamp_us = 0;
+        const rmt_item32_t *items = NULL;
+        uint32_t num_items = 0;
+        esp_err_t ret;
+        while ((ret = ir_capture_read(&reader, &timestamp_us, &items, &num_items)) == ESP_OK) {
+            esp_timer_mock_set_time(true, base_us + timestamp_us);
+            uint32_t num_codes = 0;
+            uint64_t start = replay_now_ns();
+            // Parsers only read the raw data
+            parser->decode_batch(parser, (void *)items, num_items, codes, REPLAY_MAX_CODES, &num_codes);
+            uint64_t elapsed = replay_now_ns() - start;
+            latencies[record++] = elapsed;
+            busy_ns += elapsed;
+            items_total += num_items;
+            codes_total += num_codes;
+            for (uint32_t i = 0; i < num_codes; i++) {
+                repeats_total += codes[i].repeat;
+                if (verbose && loop == 0) {
+                    printf("%12.6f %-8s addr: 0x%04x cmd: 0x%08x%s\n", timestamp_us / 1e6, codes[i].protocol->name,
+                           codes[i].address, codes[i].command, codes[i].repeat ? " (repeat)" : "");
+                }
+            }
+        }
+        if (ret != ESP_ERR_NOT_FOUND) {
+            fprintf(stderr, "capture truncated at record %u\n", reader.record);
+            return EXIT_FAILURE;
+        }
+        span_us = timestamp_us;
+    }
+
+    ir_parser_stats_t total = {0};
+    printf("capture: %u records, %llu items per loop, %.3f s, counter clock %u Hz, %u loop(s)\n", reader.header.records,
+           (unsigned long long)(items_total / loops), span_us / 1e6, reader.header.counter_clk_hz, loops);
+    for (uint32_t i = 0; i < num_parsers; i++) {
+        ir_parser_stats_t stats;
+        ir_parser_rmt_get_stats(protocol_parsers[i], &stats);
+        printf("  %-8s %u frames (%u repeats)\n", parser_protocols[i]->name, stats.frames, stats.repeats);
+        if (num_parsers == 1) {
+            total = stats;
+            break;
+        }
+        total.frames += stats.frames;
+        total.repeats += stats.repeats;
+        total.head_level += stats.head_level;
+        total.head_mark += stats.head_mark;
+        total.head_space += stats.head_space;
+        total.bit_timing += stats.bit_timing;
+        total.length += stats.length;
+        total.trailer += stats.trailer;
+    }
+    uint32_t rejected = total.head_level + total.head_mark + total.head_space + total.bit_timing + total.length + total.trailer;
+    printf("decoded: %u frames, %llu scan codes reported (%llu repeats), %.1f%% of %u candidate frames\n", total.frames,
+           (unsigned long long)codes_total, (unsigned long long)repeats_total,
+           total.frames + rejected ? 100.0 * total.frames / (total.frames + rejected) : 0.0, total.frames + rejected);
+    printf("rejected: head level %u, head mark %u, head space %u, bit timing %u, length %u, trailer %u\n", total.head_level,
+           total.head_mark, total.head_space, total.bit_timing, total.length, total.trailer);
+    printf("throughput: %.0f frames/s, %.0f items/s\n", busy_ns ? total.frames * 1e9 / busy_ns : 0.0,
+           busy_ns ? items_total * 1e9 / busy_ns : 0.0);
+    qsort(latencies, record, sizeof(latencies[0]), replay_compare_u64);
+    printf("latency per record (ns): p50 %llu, p90 %llu, p99 %llu, max %llu\n",
+           (unsigned long long)replay_percentile(latencies, record, 50), (unsigned long long)replay_percentile(latencies, record, 90),
+           (unsigned long long)replay_percentile(latencies, record, 99), (unsigned long long)(record ? latencies[record - 1] : 0));
+    if (config.flags & IR_TOOLS_FLAGS_CALIBRATE) {
+        for (uint32_t i = 0; i < num_parsers; i++) {
+            ir_parser_calibration_t calibration;
+            ir_parser_rmt_get_calibration(protocol_parsers[i], &calibration);
+            printf("calibration %-8s remote 0x%x: head %+d/%+d us, bit %+d/%+d us, ending %+d us, margins %u/%u/%u/%u/%u us, "
+                   "%u frames\n", parser_protocols[i]->name, calibration.address, calibration.head_mark.offset_us, calibration.head_space.offset_us,
+                   calibration.bit_mark.offset_us, calibration.bit_space.offset_us, calibration.ending_mark.offset_us,
+                   calibration.head_mark.margin_us, calibration.head_space.margin_us, calibration.bit_mark.margin_us,
+                   calibration.bit_space.margin_us, calibration.ending_mark.margin_us, calibration.frames);
+        }
+    }
+
+    esp_timer_mock_set_time(false, 0);
+    free(latencies);
+    parser->del(parser);
+    free(data);
+    return EXIT_SUCCESS;
+}
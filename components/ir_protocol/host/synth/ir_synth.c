@@ -0,0 +1,371 @@
+// Synthetic noisy-signal benchmark of the Samsung decoder.
+//
+// Usage: ir_synth [-n frames] [-m margin_us] [-d batch|stream|single] [-c] [-s jitter|skew|glitch|truncate|none]
+//                 [-j jitter_us] [-k skew_us] [-g glitches] [-w glitch_us] [-t truncated] [-f filter_us] [-S seed]
+//                 [-o capture.bin]
+//
+// Frames with random address and command are built by the Samsung builder,
+// looped back the way the IR receiver presents them, then perturbed:
+//   jitter    every mark and space moves by up to +/- jitter_us
+//   skew      marks shortened and spaces lengthened by skew_us, like a slow receiver AGC
+//   glitch    per 1000 items, a mark or space is split by a pulse of up to glitch_us
+//   truncate  per 1000 frames, the frame is cut short at a random point
+// Each sweep point decodes -n frames and reports how many decoded to the
+// frame sent, decoded to something else, or were lost, and the decoder
+// throughput. With -f, ir_filter_glitches runs on every frame before the
+// decoder, its time included. Without a sweep (-s none) one point is run with the given
+// noise, and -o also writes the received frames as a capture for ir_replay.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "esp_log.h"
+#include "driver/rmt.h"
+#include "ir_tools.h"
+#include "ir_capture.h"
+#include "ir_filter.h"
+
+#define SYNTH_TX_CHANNEL (RMT_CHANNEL_0)
+#define SYNTH_RX_CHANNEL (RMT_CHANNEL_1)
+#define SYNTH_BLOCK_FRAMES (1024)        // frames generated, then decoded in one timed run
+#define SYNTH_MAX_GLITCHES (4)           // per frame, each adds two segments
+#define SYNTH_FRAME_ITEMS (16 + 32 + 2)      // IR_PROTOCOL_FRAME_ITEMS of Samsung, as a constant
+#define SYNTH_MAX_SEGMENTS (2 * SYNTH_FRAME_ITEMS + 2 * SYNTH_MAX_GLITCHES)
+#define SYNTH_MAX_ITEMS ((SYNTH_MAX_SEGMENTS + 1) / 2)
+#define SYNTH_FRAME_PERIOD_US (110000)   // capture timestamps
+#define SYNTH_SWEEP_POINTS (11)
+
+typedef enum {
+    SYNTH_DECODER_BATCH,
+    SYNTH_DECODER_STREAM,
+    SYNTH_DECODER_SINGLE,
+} synth_decoder_t;
+
+typedef struct {
+    uint32_t jitter_us;
+    uint32_t skew_us;
+    uint32_t glitch_per_mille;    // per item
+    uint32_t glitch_us;           // longest glitch
+    uint32_t truncate_per_mille;  // per frame
+} synth_noise_t;
+
+typedef struct {
+    rmt_item32_t items[SYNTH_MAX_ITEMS];
+    uint32_t num_items;
+    uint32_t address;
+    uint32_t command;
+} synth_frame_t;
+
+typedef struct {
+    uint64_t frames;
+    uint64_t decoded;
+    uint64_t miscoded;
+    uint64_t decode_ns;
+} synth_result_t;
+
+static uint32_t s_rng = 0x2545F491;
+static volatile uint32_t s_sink;
+
+// xorshift32: cheap enough not to dominate the generation of millions of frames
+static inline uint32_t synth_random(void)
+{
+    s_rng ^= s_rng << 13;
+    s_rng ^= s_rng >> 17;
+    s_rng ^= s_rng << 5;
+    return s_rng;
+}
+
+static inline uint32_t synth_below(uint32_t bound)
+{
+    return bound ? (uint32_t)(((uint64_t)synth_random() * bound) >> 32) : 0;
+}
+
+static uint64_t synth_now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static inline uint32_t synth_clamp(int32_t ticks)
+{
+    return ticks < 1 ? 1 : ticks > 0x7FFF ? 0x7FFF : (uint32_t)ticks;
+}
+
+// Turn a built frame into what the receiver would deliver with the given noise
+static void synth_perturb(const synth_noise_t *noise, uint32_t ticks_per_us, const rmt_item32_t *tx, size_t tx_length,
+                          synth_frame_t *frame)
+{
+    uint32_t durations[SYNTH_MAX_SEGMENTS];
+    uint32_t num_segments = 0;
+    int32_t skew = noise->skew_us * ticks_per_us;
+    uint32_t jitter = noise->jitter_us * ticks_per_us;
+    uint32_t glitches = 0;
+    // Segments alternate mark, space, mark... The trailing space is cut by the receiver idle threshold
+    for (size_t i = 0; i < tx_length && tx[i].duration0 && num_segments < SYNTH_MAX_SEGMENTS - 2; i++) {
+        for (int half = 0; half < 2; half++) {
+            uint32_t duration = half ? tx[i].duration1 : tx[i].duration0;
+            if (!duration) {
+                break;
+            }
+            int32_t ticks = (int32_t)duration + (half ? skew : -skew);
+            if (jitter) {
+                ticks += (int32_t)synth_below(2 * jitter + 1) - (int32_t)jitter;
+            }
+            uint32_t width = 1 + synth_below(noise->glitch_us * ticks_per_us);
+            if (glitches < SYNTH_MAX_GLITCHES && synth_below(1000) < noise->glitch_per_mille && ticks > (int32_t)width + 2) {
+                // Split by a pulse of the other level
+                uint32_t before = 1 + synth_below(ticks - width - 1);
+                durations[num_segments++] = before;
+                durations[num_segments++] = width;
+                ticks -= before + width;
+                glitches++;
+            }
+            durations[num_segments++] = synth_clamp(ticks);
+        }
+    }
+    if (!(num_segments & 1)) {
+        num_segments--;
+    }
+    if (synth_below(1000) < noise->truncate_per_mille) {
+        num_segments = 1 + 2 * synth_below(num_segments / 2);
+    }
+    // Receiver output: levels inverted, a mark is a low level
+    frame->num_items = (num_segments + 1) / 2;
+    for (uint32_t s = 0, i = 0; s < num_segments; s += 2, i++) {
+        frame->items[i].duration0 = durations[s];
+        frame->items[i].level0 = 0;
+        frame->items[i].duration1 = s + 1 < num_segments ? durations[s + 1] : 0;
+        frame->items[i].level1 = 1;
+    }
+}
+
+static void synth_generate(ir_builder_t *builder, const synth_noise_t *noise, uint32_t ticks_per_us, synth_frame_t *frames,
+                           uint32_t count)
+{
+    for (uint32_t f = 0; f < count; f++) {
+        rmt_item32_t *items = NULL;
+        size_t length = 0;
+        frames[f].address = synth_random() & 0xFFFF;
+        frames[f].command = synth_random();
+        ESP_ERROR_CHECK(builder->build_frame(builder, frames[f].address, frames[f].command));
+        ESP_ERROR_CHECK(builder->get_result(builder, &items, &length));
+        synth_perturb(noise, ticks_per_us, items, length, &frames[f]);
+    }
+}
+
+static void synth_decode(ir_parser_t *parser, synth_decoder_t decoder, uint32_t filter_ticks, synth_frame_t *frames,
+                         uint32_t count, synth_result_t *result)
+{
+    uint64_t start = synth_now_ns();
+    for (uint32_t f = 0; f < count; f++) {
+        synth_frame_t *frame = &frames[f];
+        ir_scan_code_t code;
+        uint32_t num_codes = 0;
+        if (filter_ticks) {
+            size_t num_items = frame->num_items;
+            ir_filter_glitches(frame->items, &num_items, filter_ticks, NULL);
+            frame->num_items = num_items;
+        }
+        if (decoder == SYNTH_DECODER_SINGLE) {
+            if (parser->input(parser, frame->items, frame->num_items) == ESP_OK &&
+                    parser->get_scan_code(parser, &code.address, &code.command, &code.repeat) == ESP_OK) {
+                num_codes = 1;
+            }
+        } else {
+            parser->decode_batch(parser, frame->items, frame->num_items, &code, 1, &num_codes);
+        }
+        if (num_codes) {
+            bool match = code.address == frame->address && code.command == frame->command;
+            result->decoded += match;
+            result->miscoded += !match;
+        }
+    }
+    result->decode_ns += synth_now_ns() - start;
+    result->frames += count;
+}
+
+static ir_parser_t *synth_new_parser(uint32_t margin_us, synth_decoder_t decoder, bool calibrate)
+{
+    ir_parser_config_t config = IR_PARSER_DEFAULT_CONFIG((ir_dev_t)SYNTH_RX_CHANNEL);
+    config.margin_us = margin_us;
+    config.flags |= IR_TOOLS_FLAGS_PROTO_EXT;
+    config.flags |= decoder == SYNTH_DECODER_STREAM ? IR_TOOLS_FLAGS_STREAM : 0;
+    config.flags |= calibrate ? IR_TOOLS_FLAGS_CALIBRATE : 0;
+    return ir_parser_rmt_new_samsung(&config);
+}
+
+static void synth_usage(const char *name)
+{
+    fprintf(stderr, "usage: %s [-n frames] [-m margin_us] [-d batch|stream|single] [-c] [-s jitter|skew|glitch|truncate|none]\n"
+            "       [-j jitter_us] [-k skew_us] [-g glitches] [-w glitch_us] [-t truncated] [-f filter_us] [-S seed]\n"
+            "       [-o capture.bin]\n"
+            "  -n  frames per point, default 200000\n"
+            "  -s  noise swept over %d points with the others fixed, default all of them in turn\n"
+            "  -g  glitches per 1000 items, -t truncated frames per 1000\n"
+            "  -f  merge glitches shorter than this before decoding, default 0 (off)\n"
+            "  -o  with -s none, write the received frames as a capture\n", name, SYNTH_SWEEP_POINTS);
+}
+
+int main(int argc, char **argv)
+{
+    uint32_t frames_per_point = 200000;
+    uint32_t margin_us = 200;
+    uint32_t filter_us = 0;
+    synth_decoder_t decoder = SYNTH_DECODER_BATCH;
+    bool calibrate = false;
+    const char *sweep = NULL;
+    const char *capture_path = NULL;
+    synth_noise_t base = {
+        .glitch_us = 80,
+    };
+    int opt;
+    while ((opt = getopt(argc, argv, "n:m:d:cs:j:k:g:w:t:f:S:o:")) != -1) {
+        switch (opt) {
+        case 'n':
+            frames_per_point = strtoul(optarg, NULL, 0);
+            break;
+        case 'm':
+            margin_us = strtoul(optarg, NULL, 0);
+            break;
+        case 'd':
+            decoder = !strcmp(optarg, "stream") ? SYNTH_DECODER_STREAM :
+                      !strcmp(optarg, "single") ? SYNTH_DECODER_SINGLE : SYNTH_DECODER_BATCH;
+            break;
+        case 'c':
+            calibrate = true;
+            break;
+        case 's':
+            sweep = optarg;
+            break;
+        case 'j':
+            base.jitter_us = strtoul(optarg, NULL, 0);
+            break;
+        case 'k':
+            base.skew_us = strtoul(optarg, NULL, 0);
+            break;
+        case 'g':
+            base.glitch_per_mille = strtoul(optarg, NULL, 0);
+            break;
+        case 'w':
+            base.glitch_us = strtoul(optarg, NULL, 0);
+            break;
+        case 't':
+            base.truncate_per_mille = strtoul(optarg, NULL, 0);
+            break;
+        case 'f':
+            filter_us = strtoul(optarg, NULL, 0);
+            break;
+        case 'S':
+            s_rng = strtoul(optarg, NULL, 0) | 1;
+            break;
+        case 'o':
+            capture_path = optarg;
+            break;
+        default:
+            synth_usage(argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+    if (optind != argc || !frames_per_point || (capture_path && (!sweep || strcmp(sweep, "none")))) {
+        synth_usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+    esp_log_level_set("*", ESP_LOG_NONE);
+
+    ir_builder_config_t builder_config = IR_BUILDER_DEFAULT_CONFIG((ir_dev_t)SYNTH_TX_CHANNEL);
+    builder_config.flags |= IR_TOOLS_FLAGS_PROTO_EXT;
+    ir_builder_t *builder = ir_builder_rmt_new_samsung(&builder_config);
+    uint32_t counter_clk_hz = 0;
+    rmt_get_counter_clock(SYNTH_RX_CHANNEL, &counter_clk_hz);
+    uint32_t ticks_per_us = counter_clk_hz / 1000000;
+    synth_frame_t *frames = malloc(SYNTH_BLOCK_FRAMES * sizeof(synth_frame_t));
+    if (!builder || !frames || !ticks_per_us) {
+        fprintf(stderr, "failed to set up the builder\n");
+        return EXIT_FAILURE;
+    }
+
+    static const char *const dimensions[] = {"jitter", "skew", "glitch", "truncate"};
+    static const uint32_t steps[] = {40, 30, 5, 50};
+    static const char *const decoders[] = {"batch", "stream", "single"};
+    ir_capture_writer_t capture = {0};
+    void *capture_buffer = NULL;
+    if (capture_path) {
+        size_t capacity = sizeof(ir_capture_header_t) +
+                          (size_t)frames_per_point * (sizeof(ir_capture_record_t) + SYNTH_MAX_ITEMS * sizeof(rmt_item32_t));
+        capture_buffer = malloc(capacity);
+        if (!capture_buffer || ir_capture_writer_init(&capture, capture_buffer, capacity, counter_clk_hz) != ESP_OK) {
+            fprintf(stderr, "out of memory for the capture\n");
+            return EXIT_FAILURE;
+        }
+    }
+
+    uint64_t total_frames = 0;
+    uint64_t total_ns = 0;
+    for (int d = 0; d < 4; d++) {
+        bool single_point = sweep && !strcmp(sweep, "none");
+        if (!single_point && sweep && strcmp(sweep, dimensions[d])) {
+            continue;
+        }
+        if (single_point) {
+            printf("noise: jitter %u us, skew %u us, %u glitches of up to %u us per 1000 items, %u truncated per 1000 frames\n",
+                   base.jitter_us, base.skew_us, base.glitch_per_mille, base.glitch_us, base.truncate_per_mille);
+        } else {
+            printf("sweep %s, %u frames per point, margin %u us, %s decoder%s", dimensions[d], frames_per_point, margin_us,
+                   decoders[decoder], calibrate ? ", calibrating" : "");
+            printf(filter_us ? ", glitch filter %u us\n" : "\n", filter_us);
+        }
+        printf("%10s %10s %10s %10s %12s\n", single_point ? "" : dimensions[d], "decoded%", "miscoded%", "lost%", "frames/s");
+        for (uint32_t point = 0; point < (single_point ? 1 : SYNTH_SWEEP_POINTS); point++) {
+            synth_noise_t noise = base;
+            uint32_t value = point * steps[d];
+            if (!single_point) {
+                uint32_t *fields[] = {&noise.jitter_us, &noise.skew_us, &noise.glitch_per_mille, &noise.truncate_per_mille};
+                *fields[d] = value;
+            }
+            // Fresh parser per point: calibration and stream state start over
+            ir_parser_t *parser = synth_new_parser(margin_us, decoder, calibrate);
+            if (!parser) {
+                fprintf(stderr, "failed to create the parser\n");
+                return EXIT_FAILURE;
+            }
+            synth_result_t result = {0};
+            for (uint32_t done = 0; done < frames_per_point; done += SYNTH_BLOCK_FRAMES) {
+                uint32_t count = frames_per_point - done < SYNTH_BLOCK_FRAMES ? frames_per_point - done : SYNTH_BLOCK_FRAMES;
+                synth_generate(builder, &noise, ticks_per_us, frames, count);
+                synth_decode(parser, decoder, filter_us * ticks_per_us, frames, count, &result);
+                for (uint32_t f = 0; capture_path && f < count; f++) {
+                    ir_capture_write(&capture, (int64_t)(done + f) * SYNTH_FRAME_PERIOD_US, frames[f].items, frames[f].num_items);
+                }
+            }
+            parser->del(parser);
+            total_frames += result.frames;
+            total_ns += result.decode_ns;
+            char label[16];
+            snprintf(label, sizeof(label), "%u", value);
+            printf("%10s %10.2f %10.2f %10.2f %12.0f\n", single_point ? "" : label, 100.0 * result.decoded / result.frames,
+                   100.0 * result.miscoded / result.frames, 100.0 * (result.frames - result.decoded - result.miscoded) / result.frames,
+                   result.frames * 1e9 / result.decode_ns);
+        }
+        if (single_point) {
+            break;
+        }
+    }
+    printf("total: %llu frames decoded at %.0f frames/s\n", (unsigned long long)total_frames,
+           total_ns ? total_frames * 1e9 / total_ns : 0.0);
+
+    if (capture_path) {
+        FILE *file = fopen(capture_path, "wb");
+        if (!file || fwrite(capture_buffer, 1, capture.length, file) != capture.length) {
+            fprintf(stderr, "can't write %s\n", capture_path);
+            return EXIT_FAILURE;
+        }
+        fclose(file);
+        free(capture_buffer);
+    }
+    free(frames);
+    builder->del(builder);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,73 @@
+// Timing calibration: frames missing the windows by less than IR_PARSER_CALIB_LEARN_MARGIN margins are learned
+// from until they decode, frames missing them by more are neither decoded nor learned from.
+
+#include <string.h>
+#include "test_common.h"
+
+#define TEST_BURST_FRAMES (5)
+#define TEST_MARGIN_US (200)
+
+// Burst of frames separated by the repeat gap, marks skew_us short and spaces skew_us long
+static void test_skewed_burst(ir_builder_t *builder, uint32_t skew_us, rmt_item32_t *burst)
+{
+    uint32_t counter_clk_hz = 0;
+    TEST_CHECK(rmt_get_counter_clock(RMT_CHANNEL_1, &counter_clk_hz) == ESP_OK, "no counter clock");
+    uint32_t skew_ticks = skew_us * (counter_clk_hz / 1000000);
+    for (int f = 0; f < TEST_BURST_FRAMES; f++) {
+        rmt_item32_t *frame = &burst[f * TEST_FRAME_ITEMS];
+        test_receive_frame(builder, TEST_ADDRESS, 0xdd2207f8, frame);
+        frame[TEST_FRAME_ITEMS - 1].duration1 = f == TEST_BURST_FRAMES - 1 ? 0 : 5500;
+        for (int i = 0; i < TEST_FRAME_ITEMS; i++) {
+            frame[i].duration0 -= skew_ticks;
+            frame[i].duration1 += frame[i].duration1 ? skew_ticks : 0;
+        }
+    }
+}
+
+static uint32_t test_decode(ir_parser_t *parser, rmt_item32_t *burst)
+{
+    ir_scan_code_t codes[TEST_BURST_FRAMES];
+    uint32_t num_codes = 0;
+    TEST_CHECK(parser->decode_batch(parser, burst, TEST_BURST_FRAMES * TEST_FRAME_ITEMS, codes, TEST_BURST_FRAMES,
+                                    &num_codes) == ESP_OK, "decode_batch failed");
+    for (uint32_t i = 0; i < num_codes; i++) {
+        TEST_CHECK(codes[i].address == TEST_ADDRESS && codes[i].command == 0xdd2207f8, "frame %u decoded as 0x%x 0x%x",
+                   i, codes[i].address, codes[i].command);
+    }
+    return num_codes;
+}
+
+int main(void)
+{
+    ir_builder_t *builder = test_new_builder();
+    rmt_item32_t burst[TEST_BURST_FRAMES * TEST_FRAME_ITEMS];
+    ir_parser_calibration_t calibration;
+
+    // 250 us off: beyond the margin, within the learning margin. Without calibration every frame is lost; with
+    // it the first frame is a near miss learned from and every later one decodes
+    test_skewed_burst(builder, TEST_MARGIN_US * 5 / 4, burst);
+    ir_parser_t *parser = test_new_parser(0, 0);
+    TEST_CHECK(test_decode(parser, burst) == 0, "frames beyond the margin decoded without calibration");
+    parser->del(parser);
+    parser = test_new_parser(IR_TOOLS_FLAGS_CALIBRATE, 0);
+    uint32_t decoded = test_decode(parser, burst);
+    TEST_CHECK(decoded == TEST_BURST_FRAMES - 1, "near misses: %u of %d frames decoded", decoded, TEST_BURST_FRAMES - 1);
+    TEST_CHECK(ir_parser_rmt_get_calibration(parser, &calibration) == ESP_OK && calibration.address == TEST_ADDRESS &&
+               calibration.frames == TEST_BURST_FRAMES, "calibration learned from %u frames", calibration.frames);
+    TEST_CHECK(calibration.bit_mark.offset_us < -TEST_MARGIN_US / 2 && calibration.bit_space.offset_us > TEST_MARGIN_US / 2,
+               "offsets %d/%d us", calibration.bit_mark.offset_us, calibration.bit_space.offset_us);
+    decoded = test_decode(parser, burst);
+    TEST_CHECK(decoded == TEST_BURST_FRAMES, "calibrated: %u of %d frames decoded", decoded, TEST_BURST_FRAMES);
+    parser->del(parser);
+
+    // 450 us off: beyond the learning margin too. Nothing decodes, nothing is learned
+    test_skewed_burst(builder, TEST_MARGIN_US * IR_PARSER_CALIB_LEARN_MARGIN + 50, burst);
+    parser = test_new_parser(IR_TOOLS_FLAGS_CALIBRATE, 0);
+    TEST_CHECK(test_decode(parser, burst) == 0 && test_decode(parser, burst) == 0, "far misses decoded");
+    TEST_CHECK(ir_parser_rmt_get_calibration(parser, &calibration) == ESP_OK && calibration.frames == 0,
+               "far misses learned from: %u frames", calibration.frames);
+    parser->del(parser);
+
+    builder->del(builder);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,62 @@
+// Helpers shared by the host tests: each test is one executable registered with CTest, exiting non-zero on the
+// first failed check.
+
+#pragma once
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "driver/rmt.h"
+#include "ir_tools.h"
+
+#define TEST_ADDRESS (0xB24D)
+#define TEST_FRAME_ITEMS (50) // received Samsung frame: leading code, 48 bits, ending code
+
+// Fail the test with a message unless cond holds
+#define TEST_CHECK(cond, format, ...)                                                        \
+    do                                                                                      \
+    {                                                                                       \
+        if (!(cond))                                                                        \
+        {                                                                                   \
+            fprintf(stderr, "%s:%d: " format "\n", __FILE__, __LINE__, ##__VA_ARGS__);      \
+            exit(EXIT_FAILURE);                                                             \
+        }                                                                                   \
+    } while (0)
+
+// Build a frame and present it as the receiver would: levels inverted, terminator dropped and the trailing
+// space cut by the idle threshold
+static inline void test_receive_frame(ir_builder_t *builder, uint32_t address, uint32_t command, rmt_item32_t *rx)
+{
+    rmt_item32_t *items = NULL;
+    size_t length = 0;
+    TEST_CHECK(builder->build_frame(builder, address, command) == ESP_OK, "build_frame 0x%x failed", command);
+    TEST_CHECK(builder->get_result(builder, &items, &length) == ESP_OK && length >= TEST_FRAME_ITEMS,
+               "frame of %zu items", length);
+    for (size_t i = 0; i < TEST_FRAME_ITEMS; i++) {
+        rx[i] = items[i];
+        rx[i].level0 = !items[i].level0;
+        rx[i].level1 = !items[i].level1;
+    }
+    rx[TEST_FRAME_ITEMS - 1].duration1 = 0;
+}
+
+// Samsung builder with the default configuration
+static inline ir_builder_t *test_new_builder(void)
+{
+    ir_builder_config_t config = IR_BUILDER_DEFAULT_CONFIG((ir_dev_t)RMT_CHANNEL_0);
+    config.flags |= IR_TOOLS_FLAGS_PROTO_EXT;
+    config.buffer_size = 128;
+    ir_builder_t *builder = ir_builder_rmt_new_samsung(&config);
+    TEST_CHECK(builder, "failed to create builder");
+    return builder;
+}
+
+// Samsung parser with the default configuration and extra flags
+static inline ir_parser_t *test_new_parser(uint32_t flags, uint32_t repeat_window_ms)
+{
+    ir_parser_config_t config = IR_PARSER_DEFAULT_CONFIG((ir_dev_t)RMT_CHANNEL_1);
+    config.flags |= IR_TOOLS_FLAGS_PROTO_EXT | flags;
+    config.repeat_window_ms = repeat_window_ms;
+    ir_parser_t *parser = ir_parser_rmt_new_samsung(&config);
+    TEST_CHECK(parser, "failed to create parser");
+    return parser;
+}
@@ -0,0 +1,87 @@
+// Glitch filter edge cases: a glitch inside a level, at the start and at the end, input made only of glitches,
+// a filter of 0 and clean input.
+
+#include <string.h>
+#include "ir_filter.h"
+#include "test_common.h"
+
+#define TEST_GLITCH_TICKS (40)
+#define TEST_MAX_LEVELS (16)
+
+// Levels as received: 0 for marks, 1 for spaces, the receiver inverting the signal
+typedef struct {
+    uint32_t num_levels;
+    uint32_t durations[TEST_MAX_LEVELS]; // levels alternate starting with a mark
+} test_levels_t;
+
+// Pack levels into items, the last one ending with the 0 duration of an idle receiver
+static size_t test_pack(const test_levels_t *levels, rmt_item32_t *items)
+{
+    memset(items, 0, TEST_MAX_LEVELS / 2 * sizeof(rmt_item32_t) + sizeof(rmt_item32_t));
+    for (uint32_t i = 0; i < levels->num_levels; i++) {
+        if (i & 1) {
+            items[i / 2].level1 = 1;
+            items[i / 2].duration1 = levels->durations[i];
+        } else {
+            items[i / 2].level0 = 0;
+            items[i / 2].duration0 = levels->durations[i];
+        }
+    }
+    items[levels->num_levels / 2].level1 = 1;
+    return levels->num_levels / 2 + 1;
+}
+
+// Filter the levels in, check the result holds the levels out
+static void test_filter(const char *name, const test_levels_t *in, const test_levels_t *out, uint32_t glitch_ticks,
+                        uint32_t expected_glitches)
+{
+    rmt_item32_t items[TEST_MAX_LEVELS / 2 + 1];
+    rmt_item32_t expected[TEST_MAX_LEVELS / 2 + 1];
+    size_t num_items = test_pack(in, items);
+    size_t num_expected = out->num_levels ? test_pack(out, expected) : 0;
+    uint32_t glitches = 0;
+    TEST_CHECK(ir_filter_glitches(items, &num_items, glitch_ticks, &glitches) == ESP_OK, "%s: filter failed", name);
+    TEST_CHECK(glitches == expected_glitches, "%s: %u glitches removed, expected %u", name, glitches, expected_glitches);
+    TEST_CHECK(num_items == num_expected, "%s: %zu items left, expected %zu", name, num_items, num_expected);
+    for (size_t i = 0; i < num_items; i++) {
+        TEST_CHECK(items[i].val == expected[i].val, "%s: item %zu is 0x%08x, expected 0x%08x", name, i, items[i].val,
+                   expected[i].val);
+    }
+}
+
+int main(void)
+{
+    const test_levels_t clean = {5, {600, 600, 600, 1600, 600}};
+    test_filter("clean", &clean, &clean, TEST_GLITCH_TICKS, 0);
+    const test_levels_t mark_split = {7, {300, 20, 280, 600, 600, 1600, 600}};
+    test_filter("filter off", &mark_split, &mark_split, 0, 0);
+
+    // Inside a mark or a space: merged with both neighbours into one level of their total duration
+    const test_levels_t mark_merged = {5, {600, 600, 600, 1600, 600}};
+    test_filter("in a mark", &mark_split, &mark_merged, TEST_GLITCH_TICKS, 1);
+    const test_levels_t space_split = {7, {600, 600, 600, 800, 20, 780, 600}};
+    test_filter("in a space", &space_split, &mark_merged, TEST_GLITCH_TICKS, 1);
+
+    // At the start: dropped with the gap that follows it, the frame starts at the next mark
+    const test_levels_t leading = {7, {20, 3000, 600, 600, 600, 1600, 600}};
+    test_filter("at the start", &leading, &clean, TEST_GLITCH_TICKS, 1);
+
+    // At the end: dropped, the level before it keeps its own duration
+    const test_levels_t trailing = {6, {600, 600, 600, 1600, 600, 20}};
+    test_filter("at the end", &trailing, &clean, TEST_GLITCH_TICKS, 1);
+
+    // Nothing but a glitch: no items left
+    const test_levels_t only = {1, {20}};
+    const test_levels_t none = {0, {0}};
+    test_filter("only glitches", &only, &none, TEST_GLITCH_TICKS, 1);
+
+    // A level of exactly glitch_ticks is kept
+    const test_levels_t edge = {5, {600, TEST_GLITCH_TICKS, 600, 1600, 600}};
+    test_filter("at the threshold", &edge, &edge, TEST_GLITCH_TICKS, 0);
+
+    size_t num_items = 0;
+    rmt_item32_t item = {0};
+    TEST_CHECK(ir_filter_glitches(NULL, &num_items, TEST_GLITCH_TICKS, NULL) == ESP_ERR_INVALID_ARG &&
+               ir_filter_glitches(&item, NULL, TEST_GLITCH_TICKS, NULL) == ESP_ERR_INVALID_ARG, "null arguments accepted");
+    return EXIT_SUCCESS;
+}
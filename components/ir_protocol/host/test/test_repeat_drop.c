@@ -0,0 +1,73 @@
+// Repeat suppression: a scan code identical to the previous one within repeat_window_ms is flagged as a
+// repeat, and with IR_TOOLS_FLAGS_DROP_REPEAT not returned at all; any other code, or the same one later, is.
+
+#include <string.h>
+#include "esp_timer.h"
+#include "test_common.h"
+
+#define TEST_WINDOW_MS (200)
+
+// Decode one frame received at time_ms, return the number of codes reported (0 or 1)
+static uint32_t test_receive_at(ir_parser_t *parser, rmt_item32_t *frame, int64_t time_ms, uint32_t *command,
+                                bool *repeat)
+{
+    ir_scan_code_t code;
+    uint32_t num_codes = 0;
+    esp_timer_mock_set_time(true, time_ms * 1000);
+    TEST_CHECK(parser->decode_batch(parser, frame, TEST_FRAME_ITEMS, &code, 1, &num_codes) == ESP_OK,
+               "decode_batch failed");
+    if (num_codes) {
+        *command = code.command;
+        *repeat = code.repeat;
+    }
+    return num_codes;
+}
+
+int main(void)
+{
+    ir_builder_t *builder = test_new_builder();
+    rmt_item32_t frame_a[TEST_FRAME_ITEMS];
+    rmt_item32_t frame_b[TEST_FRAME_ITEMS];
+    test_receive_frame(builder, TEST_ADDRESS, 0xdd2207f8, frame_a);
+    test_receive_frame(builder, TEST_ADDRESS, 0xf80721de, frame_b);
+    uint32_t command = 0;
+    bool repeat = false;
+    ir_parser_stats_t stats;
+
+    // Flagged, not dropped
+    ir_parser_t *parser = test_new_parser(0, TEST_WINDOW_MS);
+    TEST_CHECK(test_receive_at(parser, frame_a, 1000, &command, &repeat) == 1 && !repeat, "first frame");
+    TEST_CHECK(test_receive_at(parser, frame_a, 1100, &command, &repeat) == 1 && repeat, "repeat not flagged");
+    parser->del(parser);
+
+    // Dropped
+    parser = test_new_parser(IR_TOOLS_FLAGS_DROP_REPEAT, TEST_WINDOW_MS);
+    TEST_CHECK(test_receive_at(parser, frame_a, 1000, &command, &repeat) == 1 && command == 0xdd2207f8 && !repeat,
+               "first frame");
+    TEST_CHECK(test_receive_at(parser, frame_a, 1100, &command, &repeat) == 0, "repeat within the window reported");
+    TEST_CHECK(test_receive_at(parser, frame_b, 1150, &command, &repeat) == 1 && command == 0xf80721de && !repeat,
+               "another command dropped");
+    TEST_CHECK(test_receive_at(parser, frame_b, 1150 + TEST_WINDOW_MS / 2, &command, &repeat) == 0,
+               "repeat of the other command reported");
+    TEST_CHECK(test_receive_at(parser, frame_b, 1150 + 3 * TEST_WINDOW_MS, &command, &repeat) == 1 && !repeat,
+               "same command after the window dropped");
+    TEST_CHECK(ir_parser_rmt_get_stats(parser, &stats) == ESP_OK && stats.frames == 5 && stats.repeats == 2,
+               "stats: %u frames, %u repeats", stats.frames, stats.repeats);
+    parser->del(parser);
+
+    // Frame, gap and repeated frame in one burst, as the TX service sends them: one code
+    rmt_item32_t burst[2 * TEST_FRAME_ITEMS];
+    memcpy(burst, frame_a, sizeof(frame_a));
+    memcpy(&burst[TEST_FRAME_ITEMS], frame_a, sizeof(frame_a));
+    burst[TEST_FRAME_ITEMS - 1].duration1 = 5500;
+    ir_scan_code_t codes[2];
+    uint32_t num_codes = 0;
+    parser = test_new_parser(IR_TOOLS_FLAGS_DROP_REPEAT, TEST_WINDOW_MS);
+    TEST_CHECK(parser->decode_batch(parser, burst, 2 * TEST_FRAME_ITEMS, codes, 2, &num_codes) == ESP_OK &&
+               num_codes == 1 && !codes[0].repeat, "repeated frame: %u codes", num_codes);
+    parser->del(parser);
+
+    esp_timer_mock_set_time(false, 0);
+    builder->del(builder);
+    return EXIT_SUCCESS;
+}
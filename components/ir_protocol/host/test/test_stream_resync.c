@@ -0,0 +1,68 @@
+// Stream parser resynchronization: noise and a frame cut short, delivered in chunks that split items across
+// input calls, must not hide the frame that follows them.
+
+#include <string.h>
+#include "test_common.h"
+
+#define TEST_CUT_ITEMS (20)
+#define TEST_NOISE_ITEMS (3)
+
+// Feed items in chunks of chunk items, return the scan codes decoded
+static uint32_t test_feed(ir_parser_t *parser, rmt_item32_t *items, size_t length, size_t chunk, uint32_t *commands)
+{
+    uint32_t num_codes = 0;
+    for (size_t offset = 0; offset < length; offset += chunk) {
+        size_t size = length - offset < chunk ? length - offset : chunk;
+        TEST_CHECK(parser->input(parser, &items[offset], size) == ESP_OK, "input of %zu items failed", size);
+        uint32_t address = 0;
+        uint32_t command = 0;
+        bool repeat = false;
+        while (parser->get_scan_code(parser, &address, &command, &repeat) == ESP_OK) {
+            TEST_CHECK(address == TEST_ADDRESS, "address 0x%x", address);
+            commands[num_codes++] = command;
+        }
+    }
+    return num_codes;
+}
+
+int main(void)
+{
+    ir_builder_t *builder = test_new_builder();
+    rmt_item32_t cut_frame[TEST_FRAME_ITEMS];
+    rmt_item32_t frame[TEST_FRAME_ITEMS];
+    test_receive_frame(builder, TEST_ADDRESS, 0xdd2207f8, cut_frame);
+    test_receive_frame(builder, TEST_ADDRESS, 0xf80721de, frame);
+
+    // Short noise pulses, the first TEST_CUT_ITEMS items of a frame, then a whole frame; every chunk size
+    // from one item to the whole sequence
+    rmt_item32_t items[TEST_NOISE_ITEMS + TEST_CUT_ITEMS + TEST_FRAME_ITEMS];
+    for (size_t i = 0; i < TEST_NOISE_ITEMS; i++) {
+        items[i] = frame[1];
+        items[i].duration0 = 300;
+        items[i].duration1 = 300;
+    }
+    memcpy(&items[TEST_NOISE_ITEMS], cut_frame, TEST_CUT_ITEMS * sizeof(rmt_item32_t));
+    memcpy(&items[TEST_NOISE_ITEMS + TEST_CUT_ITEMS], frame, sizeof(frame));
+    size_t length = sizeof(items) / sizeof(items[0]);
+    for (size_t chunk = 1; chunk <= length; chunk++) {
+        ir_parser_t *parser = test_new_parser(IR_TOOLS_FLAGS_STREAM, 0);
+        uint32_t commands[4];
+        uint32_t num_codes = test_feed(parser, items, length, chunk, commands);
+        TEST_CHECK(num_codes == 1 && commands[0] == 0xf80721de, "chunks of %zu: %u codes, first 0x%x", chunk,
+                   num_codes, num_codes ? commands[0] : 0);
+        parser->del(parser);
+    }
+
+    // The cut frame ended by the receiver going idle, as when the signal is lost mid-frame
+    items[TEST_NOISE_ITEMS + TEST_CUT_ITEMS - 1].duration1 = 0;
+    for (size_t chunk = 1; chunk <= length; chunk++) {
+        ir_parser_t *parser = test_new_parser(IR_TOOLS_FLAGS_STREAM, 0);
+        uint32_t commands[4];
+        uint32_t num_codes = test_feed(parser, items, length, chunk, commands);
+        TEST_CHECK(num_codes == 1 && commands[0] == 0xf80721de, "idle cut, chunks of %zu: %u codes", chunk, num_codes);
+        parser->del(parser);
+    }
+
+    builder->del(builder);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,81 @@
+// TX queue coalescing: a newer command to a unit replaces the pending one in place, keeping its place and the
+// higher priority; a command equal to the last one sent to its unit is skipped; a command replaced while it
+// was being sent stays queued.
+
+#include "ir_tx_queue.h"
+#include "test_common.h"
+
+static ir_tx_command_t test_command(uint32_t unit, uint32_t command, uint8_t priority)
+{
+    ir_tx_command_t cmd = {
+        .unit = unit,
+        .address = TEST_ADDRESS,
+        .command = command,
+        .priority = priority,
+        .channels = 1,
+    };
+    return cmd;
+}
+
+static void test_pop(ir_tx_queue_t *queue, uint32_t unit, uint32_t command)
+{
+    ir_tx_command_t popped;
+    TEST_CHECK(ir_tx_queue_pop(queue, &popped) == ESP_OK, "queue empty, expected unit %u", unit);
+    TEST_CHECK(popped.unit == unit && popped.command == command, "popped unit %u command 0x%x, expected unit %u 0x%x",
+               popped.unit, popped.command, unit, command);
+}
+
+int main(void)
+{
+    ir_tx_queue_t queue;
+    bool coalesced = false;
+    bool skipped = false;
+
+    // Unit 1 updated twice while unit 2 waits: two commands pending, unit 1 first with its newest command
+    ir_tx_queue_init(&queue);
+    ir_tx_command_t cmd = test_command(1, 0x10, 0);
+    TEST_CHECK(ir_tx_queue_push(&queue, &cmd, &coalesced) == ESP_OK && !coalesced, "first push coalesced");
+    cmd = test_command(2, 0x20, 0);
+    TEST_CHECK(ir_tx_queue_push(&queue, &cmd, &coalesced) == ESP_OK && !coalesced, "other unit coalesced");
+    cmd = test_command(1, 0x11, 0);
+    TEST_CHECK(ir_tx_queue_push(&queue, &cmd, &coalesced) == ESP_OK && coalesced, "update not coalesced");
+    TEST_CHECK(queue.count == 2 && queue.coalesced == 1, "%u pending, %u coalesced", queue.count, queue.coalesced);
+    test_pop(&queue, 1, 0x11);
+    test_pop(&queue, 2, 0x20);
+
+    // A replacement keeps the higher priority of both
+    ir_tx_queue_init(&queue);
+    cmd = test_command(1, 0x10, 5);
+    ir_tx_queue_push(&queue, &cmd, NULL);
+    cmd = test_command(2, 0x20, 3);
+    ir_tx_queue_push(&queue, &cmd, NULL);
+    cmd = test_command(1, 0x11, 0);
+    ir_tx_queue_push(&queue, &cmd, NULL);
+    test_pop(&queue, 1, 0x11);
+    test_pop(&queue, 2, 0x20);
+
+    // A command equal to the last one sent is skipped, and drops a pending different one with it
+    ir_tx_queue_init(&queue);
+    cmd = test_command(1, 0x10, 0);
+    ir_tx_queue_push_changed(&queue, &cmd, &skipped);
+    test_pop(&queue, 1, 0x10);
+    ir_tx_queue_mark_sent(&queue, &cmd);
+    cmd = test_command(1, 0x12, 0);
+    TEST_CHECK(ir_tx_queue_push_changed(&queue, &cmd, &skipped) == ESP_OK && !skipped, "changed command skipped");
+    cmd = test_command(1, 0x10, 0);
+    TEST_CHECK(ir_tx_queue_push_changed(&queue, &cmd, &skipped) == ESP_OK && skipped, "unchanged command queued");
+    TEST_CHECK(!queue.count && queue.skipped == 1, "%u pending after the unit got its state back", queue.count);
+
+    // Replaced between peek and commit: the newer command stays queued
+    ir_tx_queue_init(&queue);
+    ir_tx_command_t peeked;
+    cmd = test_command(1, 0x10, 0);
+    ir_tx_queue_push(&queue, &cmd, NULL);
+    TEST_CHECK(ir_tx_queue_peek_ready(&queue, 1, &peeked) == ESP_OK, "nothing ready");
+    cmd = test_command(1, 0x11, 0);
+    ir_tx_queue_push(&queue, &cmd, NULL);
+    TEST_CHECK(ir_tx_queue_commit(&queue, &peeked) == ESP_ERR_NOT_FOUND && queue.count == 1,
+               "replaced command committed");
+    test_pop(&queue, 1, 0x11);
+    return EXIT_SUCCESS;
+}
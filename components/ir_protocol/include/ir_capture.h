@@ -0,0 +1,141 @@
+// Copyright 2019 Espressif Systems (Shanghai) PTE LTD
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+#include <stdint.h>
+#include "esp_err.h"
+#include "driver/rmt.h"
+
+#define IR_CAPTURE_MAGIC (0x50414349)  /*!< "ICAP" in a little endian file */
+#define IR_CAPTURE_VERSION (1)
+
+/**
+* @brief Header at the start of a capture
+*
+* A capture is this header followed by records, all fields little endian:
+* each record is an ir_capture_record_t followed by its num_items rmt_item32_t,
+* as received from the RMT ring buffer in one piece.
+*/
+typedef struct {
+    uint32_t magic;          /*!< IR_CAPTURE_MAGIC */
+    uint16_t version;        /*!< IR_CAPTURE_VERSION */
+    uint16_t reserved;
+    uint32_t counter_clk_hz; /*!< RMT counter clock the item durations are counted in */
+    uint32_t records;        /*!< Records in the capture */
+} ir_capture_header_t;
+
+/**
+* @brief Header of one record of a capture
+*
+*/
+typedef struct {
+    uint32_t delta_us;       /*!< Time since the previous record, 0 for the first one, saturated */
+    uint32_t num_items;      /*!< Items following this header */
+} ir_capture_record_t;
+
+/**
+* @brief Recorder appending received items to a capture in caller memory
+*
+*/
+typedef struct {
+    uint8_t *buffer;         /*!< Capture, starting with its header */
+    size_t capacity;
+    size_t length;           /*!< Bytes of the capture written so far */
+    int64_t last_us;         /*!< Timestamp of the last record */
+} ir_capture_writer_t;
+
+/**
+* @brief Reader walking through the records of a capture in memory
+*
+*/
+typedef struct {
+    const uint8_t *data;
+    size_t size;
+    size_t offset;           /*!< Offset of the next record */
+    uint32_t record;         /*!< Index of the next record */
+    int64_t timestamp_us;    /*!< Timestamp of the last record read, relative to the first one */
+    ir_capture_header_t header;
+} ir_capture_reader_t;
+
+/**
+* @brief Start a capture in a buffer
+*
+* @param[out] writer: Recorder
+* @param[in] buffer: Buffer receiving the capture, 4-byte aligned
+* @param[in] capacity: Capacity of buffer in bytes
+* @param[in] counter_clk_hz: RMT counter clock of the recorded channel
+*
+* @return
+*      - ESP_OK: Start capture successfully
+*      - ESP_ERR_INVALID_ARG: Start capture failed because of invalid arguments
+*      - ESP_ERR_NO_MEM: Buffer can't hold the capture header
+*/
+esp_err_t ir_capture_writer_init(ir_capture_writer_t *writer, void *buffer, size_t capacity, uint32_t counter_clk_hz);
+
+/**
+* @brief Append received items to a capture, e.g. every ring buffer item of the RX task
+*
+* Cheap enough for the RX path: one header and a copy of the items, no allocation.
+*
+* @param[in] writer: Recorder
+* @param[in] timestamp_us: Receive time of the items, e.g. esp_timer_get_time()
+* @param[in] items: Items received
+* @param[in] num_items: Number of items
+*
+* @return
+*      - ESP_OK: Append record successfully
+*      - ESP_ERR_INVALID_ARG: Append record failed because of invalid arguments
+*      - ESP_ERR_NO_MEM: Capture full, nothing was appended
+*/
+esp_err_t ir_capture_write(ir_capture_writer_t *writer, int64_t timestamp_us, const rmt_item32_t *items, uint32_t num_items);
+
+/**
+* @brief Open a capture held in memory
+*
+* @param[out] reader: Reader
+* @param[in] data: Capture, 4-byte aligned
+* @param[in] size: Size of the capture in bytes
+*
+* @return
+*      - ESP_OK: Open capture successfully
+*      - ESP_ERR_INVALID_ARG: Open capture failed because of invalid arguments
+*      - ESP_ERR_INVALID_VERSION: Not a capture, or of an unsupported version
+*/
+esp_err_t ir_capture_reader_init(ir_capture_reader_t *reader, const void *data, size_t size);
+
+/**
+* @brief Read the next record of a capture
+*
+* @param[in] reader: Reader
+* @param[out] timestamp_us: Receive time of the record, relative to the first one
+* @param[out] items: Items of the record, pointing into the capture
+* @param[out] num_items: Number of items
+*
+* @return
+*      - ESP_OK: Read record successfully
+*      - ESP_ERR_INVALID_ARG: Read record failed because of invalid arguments
+*      - ESP_ERR_NOT_FOUND: No more records
+*      - ESP_ERR_INVALID_SIZE: Capture truncated in the middle of a record
+*/
+esp_err_t ir_capture_read(ir_capture_reader_t *reader, int64_t *timestamp_us, const rmt_item32_t **items, uint32_t *num_items);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,51 @@
+// Copyright 2019 Espressif Systems (Shanghai) PTE LTD
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+#include <stdint.h>
+#include "esp_err.h"
+#include "driver/rmt.h"
+
+/**
+* @brief Remove glitches from received items in place, before they reach a parser
+*
+* A glitch is a level shorter than glitch_ticks. One inside a mark or space is
+* merged with the levels around it into a single level of their total duration,
+* which restores the item count the parser expects. One at the start is dropped
+* together with the gap following it, one at the end is dropped. Levels are
+* kept as received, so the filter works for either polarity.
+*
+* The RMT hardware filter only removes pulses of a few APB cycles (at most
+* 255); this catches the longer ones ambient IR light produces.
+*
+* @param[in,out] items: Received items, e.g. a ring buffer item of the RX channel
+* @param[in,out] num_items: Number of items, updated to the number left
+* @param[in] glitch_ticks: Shortest level kept, in RMT counter ticks; 0 keeps every level
+* @param[out] glitches: Number of glitches removed, may be NULL
+*
+* @return
+*      - ESP_OK: Filter items successfully, *num_items is 0 if they were only glitches
+*      - ESP_ERR_INVALID_ARG: Filter items failed because of invalid arguments
+*/
+esp_err_t ir_filter_glitches(rmt_item32_t *items, size_t *num_items, uint32_t glitch_ticks, uint32_t *glitches);
+
+#ifdef __cplusplus
+}
+#endif
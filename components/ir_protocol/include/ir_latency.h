@@ -0,0 +1,111 @@
+// Copyright 2019 Espressif Systems (Shanghai) PTE LTD
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include "esp_err.h"
+#include "esp_cpu.h"
+
+#define IR_LATENCY_BUCKETS (20) /*!< Buckets of a histogram, the last one reaching about 0.5 s and holding longer samples too */
+
+/**
+* @brief Latency histogram with fixed power-of-two buckets
+*
+* Samples are counted in units of 2^unit_shift cycles, the smallest power of two not below
+* a microsecond (256 cycles, 1.07 us, at 240 MHz): bucket 0 holds samples under one unit,
+* bucket i those of at least 2^(i-1) and under 2^i units.
+*
+* Cheap enough for ISRs and hot paths: no allocation, no lock, no division when recording.
+* Single writer: readers copy it and may see a sample half recorded.
+*/
+typedef struct {
+    uint32_t cycles_per_us;               /*!< CPU cycles per microsecond of the cycle counter */
+    uint32_t unit_shift;                  /*!< Bucket unit, log2 of cycles */
+    uint32_t buckets[IR_LATENCY_BUCKETS]; /*!< Samples per bucket */
+    uint32_t count;                       /*!< Samples recorded */
+    uint32_t max_cycles;                  /*!< Longest sample */
+    uint64_t sum_cycles;                  /*!< Sum of the samples, for the mean */
+} ir_latency_hist_t;
+
+/**
+* @brief Timestamp for latency measurements: the CPU cycle counter, wrapping
+*
+* Differences of timestamps are exact as long as the interval is shorter than one wrap,
+* about 17 s at 240 MHz.
+*/
+static inline uint32_t ir_latency_now(void)
+{
+    return esp_cpu_get_ccount();
+}
+
+/**
+* @brief Empty a histogram
+*
+* @param[out] hist: Histogram
+*/
+void ir_latency_init(ir_latency_hist_t *hist);
+
+/**
+* @brief Record an interval in CPU cycles
+*
+* @param[in] hist: Histogram
+* @param[in] cycles: Interval
+*/
+void ir_latency_add(ir_latency_hist_t *hist, uint32_t cycles);
+
+/**
+* @brief Record the interval from a timestamp of ir_latency_now until now
+*
+* @param[in] hist: Histogram
+* @param[in] start: Timestamp the interval starts at
+*/
+static inline void ir_latency_since(ir_latency_hist_t *hist, uint32_t start)
+{
+    ir_latency_add(hist, ir_latency_now() - start);
+}
+
+/**
+* @brief Get an upper bound of a percentile of the recorded latencies
+*
+* @param[in] hist: Histogram
+* @param[in] percent: Percentile, 1 to 100
+* @param[out] us: Upper limit of the bucket holding the percentile, the longest sample for the last bucket
+*
+* @return
+*      - ESP_OK: Get percentile successfully
+*      - ESP_ERR_INVALID_ARG: Get percentile failed because of invalid arguments
+*      - ESP_ERR_NOT_FOUND: No sample recorded
+*/
+esp_err_t ir_latency_get_percentile(const ir_latency_hist_t *hist, uint32_t percent, uint32_t *us);
+
+/**
+* @brief Log a summary of a histogram: count, mean, p50/p90/p99 bounds and maximum
+*
+* @param[in] hist: Histogram
+* @param[in] name: Name of the measured stage
+*
+* @return
+*      - ESP_OK: Dump histogram successfully
+*      - ESP_ERR_INVALID_ARG: Dump histogram failed because of invalid arguments
+*/
+esp_err_t ir_latency_dump(const ir_latency_hist_t *hist, const char *name);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,123 @@
+// Copyright 2019 Espressif Systems (Shanghai) PTE LTD
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+#include <stdint.h>
+#include "esp_err.h"
+#include "ir_timings.h"
+
+#define IR_PROTOCOL_FLAGS_MSB_FIRST (1 << 0)     /*!< Address and command are sent most significant bit first */
+#define IR_PROTOCOL_FLAGS_INVERSE_PAIRS (1 << 1) /*!< Each 16-bit half of address and command is a byte followed by its complement */
+
+/**
+* @brief Descriptor of a pulse distance / pulse width IR protocol
+*
+* A frame is one leading code item, the address bits, the command bits and one ending code item.
+* Logic 0 and logic 1 may differ by their space (pulse distance, e.g. NEC, Samsung) or by their
+* mark (pulse width); the parser classifies bits on whichever differs more.
+*/
+typedef struct {
+    const char *name;                  /*!< Protocol name, for logs */
+    uint32_t leading_code_high_us;     /*!< Leading code mark */
+    uint32_t leading_code_low_us;      /*!< Leading code space */
+    uint32_t payload_zero_high_us;     /*!< Logic 0 mark */
+    uint32_t payload_zero_low_us;      /*!< Logic 0 space */
+    uint32_t payload_one_high_us;      /*!< Logic 1 mark */
+    uint32_t payload_one_low_us;       /*!< Logic 1 space */
+    uint32_t ending_code_high_us;      /*!< Ending code mark */
+    uint32_t ending_code_low_us;       /*!< Ending code space, gap to a following frame */
+    uint8_t address_bits;              /*!< Address bits, sent first (0..32) */
+    uint8_t command_bits;              /*!< Command bits, sent after the address (0..32) */
+    uint32_t flags;                    /*!< IR_PROTOCOL_FLAGS_* */
+    uint32_t repeat_period_ms;         /*!< Period time of sending repeat code */
+    const ir_timing_ticks_t *ticks;    /*!< Tick sets computed at compile time for common counter clocks, may be NULL */
+    size_t num_ticks;                  /*!< Number of entries in ticks */
+} ir_protocol_t;
+
+/**
+ * @brief Initializer of the descriptor timings from the timing macros of a protocol
+ *
+ * @param proto: Prefix of the protocol timing macros in ir_timings.h, e.g. SAMSUNG
+ */
+#define IR_PROTOCOL_TIMINGS(proto)                             \
+    .leading_code_high_us = proto##_LEADING_CODE_HIGH_US,      \
+    .leading_code_low_us = proto##_LEADING_CODE_LOW_US,        \
+    .payload_zero_high_us = proto##_PAYLOAD_ZERO_HIGH_US,      \
+    .payload_zero_low_us = proto##_PAYLOAD_ZERO_LOW_US,        \
+    .payload_one_high_us = proto##_PAYLOAD_ONE_HIGH_US,        \
+    .payload_one_low_us = proto##_PAYLOAD_ONE_LOW_US,          \
+    .ending_code_high_us = proto##_ENDING_CODE_HIGH_US,        \
+    .ending_code_low_us = proto##_ENDING_CODE_LOW_US
+
+/**
+ * @brief Number of RMT items of a received frame: leading code, payload bits and ending code
+ *
+ */
+#define IR_PROTOCOL_FRAME_ITEMS(protocol) ((uint32_t)(protocol)->address_bits + (protocol)->command_bits + 2)
+
+/**
+ * @brief Samsung: 16 address bits and 32 command bits, LSB first
+ *
+ */
+extern const ir_protocol_t ir_protocol_samsung;
+
+/**
+ * @brief NEC: 16 address bits and 16 command bits, LSB first
+ *
+ */
+extern const ir_protocol_t ir_protocol_nec;
+
+/**
+ * @brief Get the tick set of a protocol for an RMT counter clock
+ *
+ * Counter clocks found in the descriptor's compile-time table are served from it,
+ * any other clock is converted with the same integer rounding.
+ *
+ * @param[in] protocol: Protocol descriptor
+ * @param[in] counter_clk_hz: RMT counter clock in Hz
+ * @param[out] ticks: Tick set
+ *
+ * @return
+ *      - ESP_OK: Get tick set successfully
+ *      - ESP_ERR_INVALID_ARG: Null protocol or ticks, or zero counter clock
+ */
+esp_err_t ir_protocol_get_ticks(const ir_protocol_t *protocol, uint32_t counter_clk_hz, ir_timing_ticks_t *ticks);
+
+/**
+ * @brief Reverse the order of the low bits of a value
+ *
+ * @param[in] value: Value whose bits [0, bits) are reversed
+ * @param[in] bits: Number of bits (1..32)
+ *
+ * @return Reversed value
+ */
+static inline uint32_t ir_protocol_reverse_bits(uint32_t value, uint32_t bits)
+{
+    value = ((value >> 1) & 0x55555555) | ((value & 0x55555555) << 1);
+    value = ((value >> 2) & 0x33333333) | ((value & 0x33333333) << 2);
+    value = ((value >> 4) & 0x0F0F0F0F) | ((value & 0x0F0F0F0F) << 4);
+    value = ((value >> 8) & 0x00FF00FF) | ((value & 0x00FF00FF) << 8);
+    value = (value >> 16) | (value << 16);
+    return value >> (32 - bits);
+}
+
+#ifdef __cplusplus
+}
+#endif
@@ -18,6 +18,9 @@
 extern "C" {
 #endif
 
+#include <stdint.h>
+#include "esp_err.h"
+
 /**
  * @brief Timings for SAMSUNG protocol
  *
@@ -31,6 +34,63 @@ extern "C" {
 #define SAMSUNG_ENDING_CODE_HIGH_US     (560)
 #define SAMSUNG_ENDING_CODE_LOW_US      (5500)
 
+/**
+ * @brief Convert a duration in us to RMT counter ticks, rounded to the nearest tick
+ *
+ * A constant expression when both arguments are constants.
+ */
+#define IR_US_TO_TICKS(us, counter_clk_hz) \
+    ((uint32_t)(((uint64_t)(us) * (counter_clk_hz) + 500000) / 1000000))
+
+/**
+ * @brief Timings for NEC protocol
+ *
+ * The ending space fills the 108 ms frame period, the builder splits it over several RMT items.
+ */
+#define NEC_LEADING_CODE_HIGH_US        (9000)
+#define NEC_LEADING_CODE_LOW_US         (4500)
+#define NEC_PAYLOAD_ONE_HIGH_US         (560)
+#define NEC_PAYLOAD_ONE_LOW_US          (1690)
+#define NEC_PAYLOAD_ZERO_HIGH_US        (560)
+#define NEC_PAYLOAD_ZERO_LOW_US         (560)
+#define NEC_ENDING_CODE_HIGH_US         (560)
+#define NEC_ENDING_CODE_LOW_US          (40000)
+
+/**
+ * @brief Protocol timings converted to RMT counter ticks
+ *
+ * Shared by the builder and the parser so both always agree on every duration.
+ */
+typedef struct {
+    uint32_t counter_clk_hz;
+    uint32_t leading_code_high_ticks;
+    uint32_t leading_code_low_ticks;
+    uint32_t payload_logic0_high_ticks;
+    uint32_t payload_logic0_low_ticks;
+    uint32_t payload_logic1_high_ticks;
+    uint32_t payload_logic1_low_ticks;
+    uint32_t ending_code_high_ticks;
+    uint32_t ending_code_low_ticks;
+} ir_timing_ticks_t;
+
+/**
+ * @brief Initializer of the tick set of a protocol for a counter clock, evaluated at compile time
+ *
+ * @param proto: Prefix of the protocol timing macros above, e.g. SAMSUNG
+ */
+#define IR_TIMING_TICKS(proto, clk_hz)                                                   \
+    {                                                                                   \
+        .counter_clk_hz = (clk_hz),                                                     \
+        .leading_code_high_ticks = IR_US_TO_TICKS(proto##_LEADING_CODE_HIGH_US, clk_hz), \
+        .leading_code_low_ticks = IR_US_TO_TICKS(proto##_LEADING_CODE_LOW_US, clk_hz),   \
+        .payload_logic0_high_ticks = IR_US_TO_TICKS(proto##_PAYLOAD_ZERO_HIGH_US, clk_hz), \
+        .payload_logic0_low_ticks = IR_US_TO_TICKS(proto##_PAYLOAD_ZERO_LOW_US, clk_hz), \
+        .payload_logic1_high_ticks = IR_US_TO_TICKS(proto##_PAYLOAD_ONE_HIGH_US, clk_hz), \
+        .payload_logic1_low_ticks = IR_US_TO_TICKS(proto##_PAYLOAD_ONE_LOW_US, clk_hz),  \
+        .ending_code_high_ticks = IR_US_TO_TICKS(proto##_ENDING_CODE_HIGH_US, clk_hz),   \
+        .ending_code_low_ticks = IR_US_TO_TICKS(proto##_ENDING_CODE_LOW_US, clk_hz),     \
+    }
+
 #ifdef __cplusplus
 }
 #endif
@@ -20,9 +20,71 @@ extern "C" {
 
 #include "esp_err.h"
 #include <stdbool.h>
+#include "ir_protocol.h"
 
 #define IR_TOOLS_FLAGS_PROTO_EXT (1 << 0) /*!< Enable Extended IR protocol */
 #define IR_TOOLS_FLAGS_INVERSE (1 << 1)   /*!< Inverse the IR signal, i.e. take high level as low, and vice versa */
+#define IR_TOOLS_FLAGS_TX_RELEASE (1 << 2) /*!< Builder results stay reserved until released from the TX end callback */
+#define IR_TOOLS_FLAGS_STREAM (1 << 3)     /*!< Parser takes raw data in chunks of any size and queues every decoded scan code */
+#define IR_TOOLS_FLAGS_CALIBRATE (1 << 4)  /*!< Parser learns the timing of each remote from its frames and adapts its windows */
+#define IR_TOOLS_FLAGS_DROP_REPEAT (1 << 5) /*!< Parser drops scan codes flagged as repeats instead of reporting them */
+
+#define IR_PARSER_DISPATCH_MAX_PROTOCOLS (8) /*!< Protocols one dispatch parser can tell apart */
+#define IR_PARSER_CALIB_LEARN_MARGIN (2)     /*!< With IR_TOOLS_FLAGS_CALIBRATE, frames that miss the windows by up to this many margin_us are learned from */
+#define IR_BUILDER_RMT_CACHE_SLOTS (4)       /*!< Built frames an RMT builder keeps, each buffer_size items */
+
+/**
+* @brief Round a static size up to the 8-byte alignment of IR_TOOLS_STATIC_STORAGE
+*
+*/
+#define IR_TOOLS_STATIC_ROUND(size) (((size) + 7) & ~(size_t)7)
+
+/*
+* The *_STATIC_*SIZE values below are the sizes of the private structures of ir_tools_priv.h, on the target being
+* built for.
+*/
+
+/**
+* @brief Bytes of RMT builder state, without its frames
+*
+*/
+#define IR_BUILDER_RMT_STATIC_BASE_SIZE sizeof(ir_rmt_builder_t)
+
+/**
+* @brief Bytes of storage ir_builder_rmt_new_static needs for a buffer_size of buffer_size items
+*
+* The builder state, a scratch frame and one frame per cache slot.
+*/
+#define IR_BUILDER_RMT_STATIC_SIZE(buffer_size) \
+    (IR_BUILDER_RMT_STATIC_BASE_SIZE + (1 + IR_BUILDER_RMT_CACHE_SLOTS) * (size_t)(buffer_size) * sizeof(rmt_item32_t))
+
+/**
+* @brief Bytes of storage ir_parser_rmt_new_static needs
+*
+* Rounded so that parsers laid out back to back by ir_parser_rmt_new_dispatch_static stay aligned.
+*/
+#define IR_PARSER_RMT_STATIC_SIZE IR_TOOLS_STATIC_ROUND(sizeof(ir_rmt_parser_t))
+
+/**
+* @brief Bytes of dispatch parser state, without its protocol parsers
+*
+* Rounded so that the protocol parsers following it stay aligned.
+*/
+#define IR_PARSER_DISPATCH_STATIC_BASE_SIZE IR_TOOLS_STATIC_ROUND(sizeof(dispatch_parser_t))
+
+/**
+* @brief Bytes of storage ir_parser_rmt_new_dispatch_static needs for num_protocols protocols
+*
+*/
+#define IR_PARSER_DISPATCH_STATIC_SIZE(num_protocols) \
+    (IR_PARSER_DISPATCH_STATIC_BASE_SIZE + (size_t)(num_protocols) * IR_PARSER_RMT_STATIC_SIZE)
+
+/**
+* @brief Declare suitably aligned storage of size bytes for the *_new_static constructors
+*
+* E.g. static IR_TOOLS_STATIC_STORAGE(s_builder_storage, IR_BUILDER_RMT_STATIC_SIZE(64));
+*/
+#define IR_TOOLS_STATIC_STORAGE(name, size) uint64_t name[((size) + sizeof(uint64_t) - 1) / sizeof(uint64_t)]
 
 /**
 * @brief IR device type
@@ -42,6 +104,17 @@ typedef struct ir_builder_s ir_builder_t;
 */
 typedef struct ir_parser_s ir_parser_t;
 
+/**
+* @brief Scan code decoded by an IR parser
+*
+*/
+typedef struct {
+    uint32_t address; /*!< Address of the scan code */
+    uint32_t command; /*!< Command of the scan code */
+    bool repeat;      /*!< Indicate if it's a repeat code */
+    const ir_protocol_t *protocol; /*!< Protocol of the frame the scan code was decoded from */
+} ir_scan_code_t;
+
 /**
 * @brief Type definition of IR builder
 *
@@ -167,6 +240,13 @@ struct ir_parser_s {
     /**
     * @brief Get the scan code after decoding of raw data
     *
+    * With IR_TOOLS_FLAGS_STREAM, frames are decoded as the raw data is input (state is kept
+    * across input calls, so a frame may span several of them) and each call returns the
+    * oldest queued scan code; call it until it fails to drain every frame decoded so far.
+    *
+    * A scan code identical to the previous one and decoded within repeat_window_ms of it is
+    * flagged as a repeat; with IR_TOOLS_FLAGS_DROP_REPEAT it is not returned at all.
+    *
     * @param[in] parser: Handle of IR parser
     * @param[out] address: Address of the scan code
     * @param[out] command: Command of the scan code
@@ -179,6 +259,28 @@ struct ir_parser_s {
     */
     esp_err_t (*get_scan_code)(ir_parser_t *parser, uint32_t *address, uint32_t *command, bool *repeat);
 
+    /**
+    * @brief Decode every frame contained in a buffer of raw data in one call
+    *
+    * Replaces an input/get_scan_code pair per frame when one ring buffer item holds a burst of
+    * frames. With IR_TOOLS_FLAGS_STREAM the raw data continues the frames of previous calls and
+    * scan codes still queued from them are returned first. Repeats are flagged or dropped as
+    * by get_scan_code.
+    *
+    * @param[in] parser: Handle of IR parser
+    * @param[in] raw_data: Raw data which need decoding by IR parser
+    * @param[in] length: Length of raw data
+    * @param[out] codes: Array receiving the decoded scan codes in the order received
+    * @param[in] max_codes: Capacity of codes
+    * @param[out] num_codes: Number of scan codes written to codes
+    *
+    * @return
+    *      - ESP_OK: Decode raw data successfully, num_codes may be zero
+    *      - ESP_ERR_INVALID_ARG: Decode raw data failed because of invalid arguments
+    */
+    esp_err_t (*decode_batch)(ir_parser_t *parser, void *raw_data, uint32_t length,
+                              ir_scan_code_t *codes, uint32_t max_codes, uint32_t *num_codes);
+
     /**
     * @brief Free resources used by IR parser
     *
@@ -209,8 +311,49 @@ typedef struct {
     ir_dev_t dev_hdl;   /*!< IR device handle */
     uint32_t flags;     /*!< Flags for IR parser, different flags will enable different features */
     uint32_t margin_us; /*!< Timing parameter, indicating the tolerance to environment noise */
+    uint32_t repeat_window_ms; /*!< A scan code identical to the previous one decoded at most this long after it is a repeat, 0 to disable */
 } ir_parser_config_t;
 
+/**
+* @brief Decode statistics of an IR parser
+*
+* Rejected frames are counted by the first check they failed.
+*/
+typedef struct {
+    uint32_t frames;     /*!< Frames decoded successfully */
+    uint32_t head_level; /*!< Leading code with wrong levels */
+    uint32_t head_mark;  /*!< Leading code mark out of range */
+    uint32_t head_space; /*!< Leading code space out of range */
+    uint32_t bit_timing; /*!< Payload item that is neither logic 0 nor logic 1 */
+    uint32_t length;     /*!< Raw data of the wrong length */
+    uint32_t trailer;    /*!< Ending code with wrong levels or out of range */
+    uint32_t repeats;    /*!< Decoded frames flagged as repeats, included in frames */
+} ir_parser_stats_t;
+
+/**
+* @brief Learned timing of one kind of duration
+*
+*/
+typedef struct {
+    int32_t offset_us;  /*!< Mean observed minus nominal duration, the acceptance window is centred on nominal + offset */
+    uint32_t margin_us; /*!< Accepted deviation from nominal + offset */
+} ir_parser_timing_calibration_t;
+
+/**
+* @brief Timing calibration of an IR parser, as learned from a remote
+*
+* Durations are in microseconds so a calibration can be imported at another RMT counter clock.
+*/
+typedef struct {
+    ir_parser_timing_calibration_t head_mark;   /*!< Leading code mark */
+    ir_parser_timing_calibration_t head_space;  /*!< Leading code space */
+    ir_parser_timing_calibration_t bit_mark;    /*!< Payload marks */
+    ir_parser_timing_calibration_t bit_space;   /*!< Payload spaces, also moves the logic 0/1 threshold */
+    ir_parser_timing_calibration_t ending_mark; /*!< Ending code mark */
+    uint32_t frames;                            /*!< Frames the calibration was learned from */
+    uint32_t address;                           /*!< Address sent by the remote the calibration was learned from */
+} ir_parser_calibration_t;
+
 /**
  * @brief Default configuration for IR builder
  *
@@ -231,12 +374,325 @@ typedef struct {
         .dev_hdl = dev,               \
         .flags = 0,                   \
         .margin_us = 200,             \
+        .repeat_window_ms = 0,        \
     }
 
 
-ir_builder_t* ir_builder_rmt_new_samsung(const ir_builder_config_t *config);
+/**
+* @brief Create an RMT builder for a protocol descriptor
+*
+* Ending spaces longer than one RMT item can hold are continued by idle items. build_repeat_frame
+* turns the frame of the last build_frame into frame, gap (the ending space) and the same frame again,
+* so a double send is a single non-blocking rmt_write_items; ir_builder_rmt_build_repeated_frame builds
+* that sequence without the single frame.
+*
+* @param[in] config: Builder configuration, buffer_size must hold a frame (IR_PROTOCOL_FRAME_ITEMS + 1),
+*                    or two for build_repeat_frame
+* @param[in] protocol: Protocol descriptor, must outlive the builder (e.g. &ir_protocol_samsung)
+*
+* @return Handle of IR builder or NULL
+*/
+ir_builder_t *ir_builder_rmt_new(const ir_builder_config_t *config, const ir_protocol_t *protocol);
+
+/**
+* @brief Create an RMT builder for the Samsung protocol
+*
+* Same as ir_builder_rmt_new(config, &ir_protocol_samsung).
+*
+* @param[in] config: Builder configuration
+*
+* @return Handle of IR builder or NULL
+*/
+ir_builder_t *ir_builder_rmt_new_samsung(const ir_builder_config_t *config);
+
+/**
+* @brief Create an RMT builder in caller provided storage, without allocating
+*
+* Same as ir_builder_rmt_new otherwise. del leaves the storage to the caller, who may then create
+* another builder in it, e.g. with another configuration.
+*
+* @param[in] config: Builder configuration
+* @param[in] protocol: Protocol descriptor, must outlive the builder (e.g. &ir_protocol_samsung)
+* @param[in] storage: Storage for the builder, 8-byte aligned (see IR_TOOLS_STATIC_STORAGE), must outlive it
+* @param[in] storage_size: Bytes of storage, at least IR_BUILDER_RMT_STATIC_SIZE(config->buffer_size)
+*
+* @return Handle of IR builder or NULL
+*/
+ir_builder_t *ir_builder_rmt_new_static(const ir_builder_config_t *config, const ir_protocol_t *protocol, void *storage,
+                                        size_t storage_size);
+
+/**
+* @brief Release the oldest result handed out by get_result of an RMT builder
+*
+* Only meaningful with IR_TOOLS_FLAGS_TX_RELEASE: every get_result call reserves the returned
+* items so that build_frame never overwrites a frame the RMT is still sending. Call this once
+* per transmitted result from the TX end callback; it is safe to call from ISR context.
+*
+* @param[in] builder: Handle of IR builder created by ir_builder_rmt_new
+*
+* @return
+*      - ESP_OK: Release result successfully
+*      - ESP_ERR_INVALID_STATE: No result is waiting for release
+*/
+esp_err_t ir_builder_rmt_release_result(ir_builder_t *builder);
+
+/**
+* @brief Get frame cache statistics of an RMT builder
+*
+* build_frame keeps the most recently built frames; a hit returns the cached items
+* through get_result without encoding again.
+*
+* @param[in] builder: Handle of IR builder created by ir_builder_rmt_new
+* @param[out] hits: Number of build_frame calls served from the cache
+* @param[out] misses: Number of build_frame calls that encoded a new frame
+*
+* @return
+*      - ESP_OK: Get statistics successfully
+*      - ESP_ERR_INVALID_ARG: Get statistics failed because of invalid arguments
+*/
+esp_err_t ir_builder_rmt_get_cache_stats(ir_builder_t *builder, uint32_t *hits, uint32_t *misses);
+
+/**
+* @brief Get the flags an RMT builder was created with
+*
+* E.g. for a user of the builder that relies on IR_TOOLS_FLAGS_TX_RELEASE to check it at start.
+*
+* @param[in] builder: Handle of IR builder created by ir_builder_rmt_new
+* @param[out] flags: IR_TOOLS_FLAGS_* of the builder configuration
+*
+* @return
+*      - ESP_OK: Get flags successfully
+*      - ESP_ERR_INVALID_ARG: Get flags failed because of invalid arguments
+*/
+esp_err_t ir_builder_rmt_get_flags(ir_builder_t *builder, uint32_t *flags);
+
+/**
+* @brief Build frame, gap and the same frame again for a scan code in one go
+*
+* Same result as build_frame followed by build_repeat_frame, without encoding the single frame first:
+* one encode and one cache slot per scan code instead of two. The frame counts as the last one built.
+*
+* @param[in] builder: Handle of IR builder created by ir_builder_rmt_new
+* @param[in] address: Address code of the frame
+* @param[in] command: Command code of the frame
+*
+* @return
+*      - ESP_OK: Build frames successfully
+*      - ESP_ERR_INVALID_ARG: Build frames failed because of invalid arguments
+*      - ESP_ERR_INVALID_SIZE: Build frames failed because buffer_size can't hold two frames
+*      - ESP_ERR_INVALID_STATE: Build frames failed because every cache slot is still on air
+*      - ESP_ERR_NOT_SUPPORTED: Build frames failed because the protocol has no gap after a frame
+*/
+esp_err_t ir_builder_rmt_build_repeated_frame(ir_builder_t *builder, uint32_t address, uint32_t command);
+
+/**
+* @brief Send a frame of any length without materializing its items
+*
+* The leading code, data bytes (8 payload bits each, in the protocol's bit order) and ending code
+* are translated into items on demand as the RMT driver refills channel RAM (rmt_write_sample),
+* so long aircon state frames need no item buffer. The builder registers itself as the translator
+* of its channel on first use; the RMT driver of the channel must be installed. Streamed frames hold
+* no get_result reservation: with IR_TOOLS_FLAGS_TX_RELEASE, don't release a result for them.
+*
+* @param[in] builder: Handle of IR builder created by ir_builder_rmt_new
+* @param[in] data: Frame payload, e.g. a 14 to 35 byte aircon state. Read by the RMT interrupt as the frame goes out,
+*                  so it must stay valid and unchanged until the transmission ends (rmt_wait_tx_done), also after
+*                  the call returns when wait_tx_done is false
+* @param[in] length: Number of bytes in data
+* @param[in] wait_tx_done: Whether to wait for the frame to be sent. A previous streamed frame still on air is
+*                          waited for at most one second if true, and makes the call fail at once if false
+*
+* @return
+*      - ESP_OK: Send frame successfully
+*      - ESP_ERR_INVALID_ARG: Send frame failed because of invalid arguments
+*      - ESP_ERR_TIMEOUT: Send frame failed because the previous frame on the channel is still being sent
+*      - ESP_FAIL: Send frame failed because the translator could not be installed
+*/
+esp_err_t ir_builder_rmt_stream_frame(ir_builder_t *builder, const uint8_t *data, size_t length, bool wait_tx_done);
+
+/**
+* @brief Create an RMT parser for a protocol descriptor
+*
+* @param[in] config: Parser configuration
+* @param[in] protocol: Protocol descriptor, must outlive the parser (e.g. &ir_protocol_samsung)
+*
+* @return Handle of IR parser or NULL
+*/
+ir_parser_t *ir_parser_rmt_new(const ir_parser_config_t *config, const ir_protocol_t *protocol);
+
+/**
+* @brief Create an RMT parser for the Samsung protocol
+*
+* Same as ir_parser_rmt_new(config, &ir_protocol_samsung).
+*
+* @param[in] config: Parser configuration
+*
+* @return Handle of IR parser or NULL
+*/
+ir_parser_t *ir_parser_rmt_new_samsung(const ir_parser_config_t *config);
+
+/**
+* @brief Create an RMT parser in caller provided storage, without allocating
+*
+* Same as ir_parser_rmt_new otherwise. del leaves the storage to the caller, so a parser can be
+* recreated in place, e.g. with another margin_us, without touching the heap.
+*
+* @param[in] config: Parser configuration
+* @param[in] protocol: Protocol descriptor, must outlive the parser (e.g. &ir_protocol_samsung)
+* @param[in] storage: Storage for the parser, 8-byte aligned (see IR_TOOLS_STATIC_STORAGE), must outlive it
+* @param[in] storage_size: Bytes of storage, at least IR_PARSER_RMT_STATIC_SIZE
+*
+* @return Handle of IR parser or NULL
+*/
+ir_parser_t *ir_parser_rmt_new_static(const ir_parser_config_t *config, const ir_protocol_t *protocol, void *storage,
+                                      size_t storage_size);
+
+/**
+* @brief Create a parser that decodes several protocols on one receiver
+*
+* One RMT parser is created per protocol with the same configuration. The leading code of a frame
+* is classified by bucketed lookups of its mark and space, so only the parser of the matching
+* protocol decodes it and the cost per frame does not grow with the number of protocols.
+* Scan codes tell which protocol they came from through ir_scan_code_t::protocol.
+*
+* @param[in] config: Parser configuration, shared by every protocol
+* @param[in] protocols: Protocol descriptors, leading codes must tell them apart
+* @param[in] num_protocols: Number of protocols (1..IR_PARSER_DISPATCH_MAX_PROTOCOLS)
+*
+* @return Handle of IR parser or NULL
+*/
+ir_parser_t *ir_parser_rmt_new_dispatch(const ir_parser_config_t *config, const ir_protocol_t *const *protocols,
+                                        uint32_t num_protocols);
+
+/**
+* @brief Create a dispatch parser in caller provided storage, without allocating
+*
+* Same as ir_parser_rmt_new_dispatch otherwise; the protocol parsers live in the same storage.
+* del deletes them and leaves the storage to the caller.
+*
+* @param[in] config: Parser configuration, shared by every protocol
+* @param[in] protocols: Protocol descriptors, leading codes must tell them apart
+* @param[in] num_protocols: Number of protocols (1..IR_PARSER_DISPATCH_MAX_PROTOCOLS)
+* @param[in] storage: Storage for the parsers, 8-byte aligned (see IR_TOOLS_STATIC_STORAGE), must outlive them
+* @param[in] storage_size: Bytes of storage, at least IR_PARSER_DISPATCH_STATIC_SIZE(num_protocols)
+*
+* @return Handle of IR parser or NULL
+*/
+ir_parser_t *ir_parser_rmt_new_dispatch_static(const ir_parser_config_t *config, const ir_protocol_t *const *protocols,
+                                               uint32_t num_protocols, void *storage, size_t storage_size);
+
+/**
+* @brief Get the RMT parser a dispatch parser uses for one of its protocols
+*
+* E.g. to read the statistics or calibration of that protocol. The parser stays owned by the
+* dispatch parser. Leading codes are routed on the nominal timing with the configured margin,
+* whatever the calibration of the protocol parser.
+*
+* @param[in] parser: Handle of IR parser created by ir_parser_rmt_new_dispatch
+* @param[in] index: Index of the protocol in the array given to ir_parser_rmt_new_dispatch
+* @param[out] ret_parser: Handle of the RMT parser of the protocol
+*
+* @return
+*      - ESP_OK: Get parser successfully
+*      - ESP_ERR_INVALID_ARG: Get parser failed because of invalid arguments
+*/
+esp_err_t ir_parser_dispatch_get_parser(ir_parser_t *parser, uint32_t index, ir_parser_t **ret_parser);
+
+/**
+* @brief Get the decode statistics of a dispatch parser, summed over its protocol parsers
+*
+* Bursts whose leading code matches no protocol are not frames and aren't counted.
+*
+* @param[in] parser: Handle of IR parser created by ir_parser_rmt_new_dispatch
+* @param[out] stats: Sum of the counters of every protocol parser
+*
+* @return
+*      - ESP_OK: Get statistics successfully
+*      - ESP_ERR_INVALID_ARG: Get statistics failed because of invalid arguments
+*/
+esp_err_t ir_parser_dispatch_get_stats(ir_parser_t *parser, ir_parser_stats_t *stats);
+
+/**
+* @brief Get the payload bit at which the last decode of an RMT parser gave up
+*
+* get_scan_code stops at the first payload item that is neither a logic 0 nor a logic 1.
+*
+* @param[in] parser: Handle of IR parser created by ir_parser_rmt_new
+* @param[out] bit: Index (in the order received, address first) of the failing bit, -1 if the last payload decoded
+*
+* @return
+*      - ESP_OK: Get bit index successfully
+*      - ESP_ERR_INVALID_ARG: Get bit index failed because of invalid arguments
+*/
+esp_err_t ir_parser_rmt_get_fail_bit(ir_parser_t *parser, int *bit);
+
+/**
+* @brief Get decode statistics of an RMT parser
+*
+* Counters are updated with relaxed atomics on the RX path instead of logging every rejected
+* frame; build with IR_PARSER_LOG_ERRORS=1 to also log each rejection. For a dispatch parser this is
+* ir_parser_dispatch_get_stats.
+*
+* @param[in] parser: Handle of IR parser created by ir_parser_rmt_new or ir_parser_rmt_new_dispatch
+* @param[out] stats: Snapshot of the counters
+*
+* @return
+*      - ESP_OK: Get statistics successfully
+*      - ESP_ERR_INVALID_ARG: Get statistics failed because of invalid arguments
+*/
+esp_err_t ir_parser_rmt_get_stats(ir_parser_t *parser, ir_parser_stats_t *stats);
+
+/**
+* @brief Log decode statistics of an RMT parser
+*
+* @param[in] parser: Handle of IR parser created by ir_parser_rmt_new or ir_parser_rmt_new_dispatch
+*
+* @return
+*      - ESP_OK: Log statistics successfully
+*      - ESP_ERR_INVALID_ARG: Log statistics failed because of invalid arguments
+*/
+esp_err_t ir_parser_rmt_dump_stats(ir_parser_t *parser);
+
+/**
+* @brief Export the timing calibration of an RMT parser
+*
+* With IR_TOOLS_FLAGS_CALIBRATE, every frame updates a running mean of the offset of each kind of
+* duration from its nominal value, and of the deviation around it. Acceptance windows are centred on
+* the learned timing, and once the calibration settled their margin narrows to the observed jitter,
+* never exceeding the configured margin_us. Frames that decode are learned from, and so are near
+* misses: frames that miss the windows but fit, in every duration, windows IR_PARSER_CALIB_LEARN_MARGIN
+* times the configured margin wide. Near misses are not decoded, so a remote whose timing is off by more than the margin
+* decodes once enough of its frames moved the windows, while noise, which rarely has the shape of a
+* whole frame, doesn't. Each remote, told apart by the address it sends, has its own calibration;
+* up to 4 remotes are kept, the one seen least recently is replaced. Call from the task feeding the parser.
+*
+* @param[in] parser: Handle of IR parser created by ir_parser_rmt_new
+* @param[out] calibration: Calibration of the remote seen last
+*
+* @return
+*      - ESP_OK: Export calibration successfully
+*      - ESP_ERR_INVALID_ARG: Export calibration failed because of invalid arguments
+*/
+esp_err_t ir_parser_rmt_get_calibration(ir_parser_t *parser, ir_parser_calibration_t *calibration);
+
+/**
+* @brief Import a timing calibration into an RMT parser, e.g. one saved from a previous run
+*
+* The calibration replaces the one of the remote sending calibration->address, and the windows move
+* to it immediately; with IR_TOOLS_FLAGS_CALIBRATE learning continues from the imported calibration.
+* Call from the task feeding the parser.
+*
+* @param[in] parser: Handle of IR parser created by ir_parser_rmt_new
+* @param[in] calibration: Calibration to use, a margin_us of 0 selects the configured margin
+*
+* @return
+*      - ESP_OK: Import calibration successfully
+*      - ESP_ERR_INVALID_ARG: Import calibration failed because of invalid arguments, an offset beyond half
+*                             the nominal duration or a margin above the configured one
+*/
+esp_err_t ir_parser_rmt_set_calibration(ir_parser_t *parser, const ir_parser_calibration_t *calibration);
 
-ir_parser_t* ir_parser_rmt_new_samsung(const ir_parser_config_t *config);
+#include "ir_tools_priv.h"
 
 #ifdef __cplusplus
 }
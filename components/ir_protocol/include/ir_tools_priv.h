@@ -0,0 +1,211 @@
+// Copyright 2019 Espressif Systems (Shanghai) PTE LTD
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+* Layout of the RMT builder and parsers, included by ir_tools.h so that the *_STATIC_*SIZE macros are the sizes of
+* these structures on the target being built for. Not part of the API: only the sources of the component touch
+* the fields.
+*/
+
+#include <stdatomic.h>
+#include "driver/rmt.h"
+
+#define IR_BUILDER_PENDING_DEPTH (8)         // results handed out and not yet released, must be a power of 2
+#define IR_BUILDER_MAX_GAP_ITEMS (8)         // idle items continuing an ending space longer than one item can hold
+#define IR_PARSER_SCAN_QUEUE_DEPTH (8)      // scan codes decoded in stream mode and not yet read, must be a power of 2
+#define IR_PARSER_CALIB_SOURCES (4)         // remotes calibrated separately, told apart by the address they send
+#define IR_PARSER_DISPATCH_BUCKETS (64)     // buckets per leading code duration of a dispatch parser
+
+typedef struct {
+    uint32_t address;
+    uint32_t command;
+    uint32_t last_used;
+    uint32_t length;
+    bool valid;
+    bool repeated;                      // frame, gap and repeated frame
+    rmt_item32_t *items;
+} ir_frame_slot_t;
+
+typedef struct {
+    ir_builder_t parent;
+    uint32_t buffer_size;
+    uint32_t cursor;
+    rmt_item32_t *frame;                // frame being built or last built, returned by get_result
+    uint32_t flags;
+    const ir_protocol_t *protocol;
+    ir_timing_ticks_t ticks;
+    bool inverse;
+    uint32_t head_item;                 // precomputed rmt_item32_t::val of the leading code
+    uint32_t logic0_item;               // precomputed rmt_item32_t::val of logic 0
+    uint32_t logic1_item;               // precomputed rmt_item32_t::val of logic 1
+    uint32_t end_item;                  // precomputed rmt_item32_t::val of the ending code
+    uint32_t gap_items[IR_BUILDER_MAX_GAP_ITEMS]; // rest of the ending space after end_item
+    uint32_t num_gap_items;
+    uint32_t frame_items;               // items of one frame including the gap, without terminator
+    rmt_channel_t channel;
+    bool stream_installed;              // rmt_builder_translate registered as the channel's translator
+    bool stream_head_sent;              // leading code of the streamed frame already translated
+    uint32_t stream_bit;                // items of the first untranslated byte already translated
+    uint32_t stream_tail;               // items of the ending code and gap already translated
+    uint32_t last_address;              // frame of the last build_frame, for build_repeat_frame
+    uint32_t last_command;
+    bool last_valid;
+    uint32_t nibble_items[16][4];       // items for each 4-bit value, LSB first
+    ir_frame_slot_t cache[IR_BUILDER_RMT_CACHE_SLOTS];
+    uint32_t cache_clock;
+    uint32_t cache_hits;
+    uint32_t cache_misses;
+    uint32_t frame_slot;                // slot index of frame
+    uint8_t pending[IR_BUILDER_PENDING_DEPTH]; // slot indexes handed out by get_result, oldest first
+    atomic_uint pending_head;           // advanced by ir_builder_rmt_release_result (TX end ISR)
+    atomic_uint pending_tail;           // advanced by get_result
+    rmt_item32_t buffer[0];             // scratch frame for make_* followed by one frame per cache slot
+} ir_rmt_builder_t;
+
+typedef enum {
+    IR_STREAM_WAIT_HEAD,
+    IR_STREAM_PAYLOAD,
+    IR_STREAM_ENDING,
+} ir_stream_state_t;
+
+typedef struct {
+    uint32_t lo;                        // accepted durations are in (lo, hi)
+    uint32_t hi;
+} ir_window_t;
+
+typedef enum {
+    IR_CALIB_HEAD_MARK,
+    IR_CALIB_HEAD_SPACE,
+    IR_CALIB_BIT_MARK,
+    IR_CALIB_BIT_SPACE,
+    IR_CALIB_ENDING_MARK,
+    IR_CALIB_MAX,
+} ir_calib_kind_t;
+
+typedef struct {
+    int32_t offset_q4;                  // mean observed minus nominal duration, in 1/16 tick
+    int32_t jitter_q4;                  // mean deviation around nominal + offset, in 1/16 tick
+    uint32_t margin_ticks;
+} ir_calib_t;
+
+// Durations of one frame, learned from once the frame decoded or nearly did
+typedef struct {
+    int32_t error[IR_CALIB_MAX];        // sum of observed minus nominal, in ticks
+    uint32_t deviation[IR_CALIB_MAX];   // sum of distances to nominal + offset, in 1/16 tick
+    uint32_t count[IR_CALIB_MAX];
+} ir_calib_frame_t;
+
+// Timing learned from one remote
+typedef struct {
+    uint32_t address;                   // address the remote sends
+    uint32_t frames;                    // frames learned from, 0 if the source is free
+    uint32_t seen;                      // calibration sequence of its last frame, the least recent source is replaced
+    ir_calib_t calib[IR_CALIB_MAX];
+} ir_calib_source_t;
+
+typedef struct {
+    atomic_uint frames;
+    atomic_uint head_level;
+    atomic_uint head_mark;
+    atomic_uint head_space;
+    atomic_uint bit_timing;
+    atomic_uint length;
+    atomic_uint trailer;
+    atomic_uint repeats;
+} ir_rmt_parser_stats_t;
+
+typedef struct {
+    ir_parser_t parent;
+    uint32_t flags;
+    const ir_protocol_t *protocol;
+    ir_timing_ticks_t ticks;
+    uint32_t margin_ticks;
+    uint32_t level_mask;                // level0/level1 bits of rmt_item32_t::val
+    uint32_t level_expect;              // level bits of a mark followed by a space
+    ir_window_t head_mark;
+    ir_window_t head_space;
+    ir_window_t bit_mark[2];            // by logic level, a bit must fit both windows of the level it is classified as
+    ir_window_t bit_space[2];
+    uint32_t bit_shift;                 // 0: bits differ by their mark, 16: by their space
+    uint32_t bit_threshold_ticks;       // midpoint of logic 0 and logic 1 on the differing duration
+    uint32_t bit_one_below;             // 1 if logic 1 is the shorter of the two
+    uint32_t bit_mark_ticks[2];         // nominal mark and space of logic 0 and logic 1
+    uint32_t bit_space_ticks[2];
+    uint32_t address_bits;
+    uint32_t command_bits;
+    uint32_t payload_bits;
+    uint32_t frame_items;               // leading code + payload + ending code
+    ir_window_t ending_mark;
+    ir_window_t learn[IR_CALIB_MAX];    // calibrating: wider windows of near misses, by ir_calib_kind_t (head and ending)
+    ir_window_t learn_bit_mark[2];      // calibrating: the same for payload bits, by logic level
+    ir_window_t learn_bit_space[2];
+    ir_calib_source_t sources[IR_PARSER_CALIB_SOURCES];
+    ir_calib_source_t *source;          // remote whose timing the windows follow
+    uint32_t calib_sequence;
+    ir_calib_frame_t stream_calib;      // stream mode: durations of the frame being decoded
+    bool stream_near_miss;              // stream mode: the frame being decoded only fits the learning windows
+    int fail_bit;                       // payload bit that failed the last decode, -1 if none
+    rmt_item32_t *buffer;
+    uint32_t buffer_length;
+    uint32_t cursor;
+    uint32_t last_address;
+    uint32_t last_command;
+    int64_t last_time_us;               // when the last scan code was decoded
+    bool last_valid;
+    int64_t repeat_window_us;           // 0: never flag repeats
+    bool inverse;
+    ir_stream_state_t stream_state;     // stream mode: frame decoding state carried across input calls
+    uint32_t stream_bit;
+    uint32_t stream_address;
+    uint32_t stream_command;
+    ir_scan_code_t scan_queue[IR_PARSER_SCAN_QUEUE_DEPTH];
+    uint32_t scan_queue_head;
+    uint32_t scan_queue_tail;
+    ir_rmt_parser_stats_t stats;
+} ir_rmt_parser_t;
+
+typedef struct {
+    uint32_t lo;                        // accepted durations are in (lo, hi)
+    uint32_t hi;
+} dispatch_window_t;
+
+typedef struct {
+    ir_parser_t *parser;
+    uint32_t frame_items;
+    dispatch_window_t head_mark;
+    dispatch_window_t head_space;
+} dispatch_route_t;
+
+typedef struct {
+    ir_parser_t parent;
+    uint32_t flags;
+    uint32_t level_mask;                // level0/level1 bits of rmt_item32_t::val
+    uint32_t level_expect;              // level bits of a mark followed by a space
+    uint32_t bucket_shift;              // duration >> bucket_shift is the bucket index
+    uint8_t mark_buckets[IR_PARSER_DISPATCH_BUCKETS];
+    uint8_t space_buckets[IR_PARSER_DISPATCH_BUCKETS];
+    int active;                         // route of the frame being decoded, -1 if none
+    uint32_t num_routes;
+    dispatch_route_t routes[IR_PARSER_DISPATCH_MAX_PROTOCOLS];
+} dispatch_parser_t;
+
+#ifdef __cplusplus
+}
+#endif
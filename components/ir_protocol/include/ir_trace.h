@@ -0,0 +1,134 @@
+// Copyright 2019 Espressif Systems (Shanghai) PTE LTD
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include "esp_err.h"
+
+/**
+* @brief Events of the IR path recorded in a trace
+*
+*/
+typedef enum {
+    IR_TRACE_TX_START,    /*!< Items written to an RMT TX channel; channel: RMT channel, payload: command */
+    IR_TRACE_TX_END,      /*!< TX end interrupt; channel: RMT channel, payload: channels of the transmission still sending */
+    IR_TRACE_RX_DELIVER,  /*!< Ring buffer item received by the decode task; channel: receiver, payload: items */
+    IR_TRACE_DECODE_OK,   /*!< Scan code decoded; channel: receiver, payload: command */
+    IR_TRACE_DECODE_FAIL, /*!< Frames the parser rejected in a burst; channel: receiver, payload: frames rejected */
+    IR_TRACE_REPEAT_DROP, /*!< Repeats dropped by the parser (IR_TOOLS_FLAGS_DROP_REPEAT); channel: receiver, payload: repeats */
+    IR_TRACE_EVENT_MAX,
+} ir_trace_event_t;
+
+/**
+* @brief One recorded event
+*
+*/
+typedef struct {
+    uint32_t timestamp_us; /*!< esp_timer time of the event, wrapping; common to both cores */
+    uint16_t event;        /*!< ir_trace_event_t */
+    uint16_t channel;      /*!< Channel or receiver of the event */
+    uint32_t payload;      /*!< Value of the event, see ir_trace_event_t */
+} ir_trace_record_t;
+
+/**
+* @brief Slot of a trace ring, provided by the caller
+*
+*/
+typedef struct {
+    uint32_t seq;              /*!< Ring position the slot is ready to be written at, or read at minus one */
+    ir_trace_record_t record;  /*!< Event */
+} ir_trace_slot_t;
+
+/**
+* @brief Lock-free ring of events: any number of writers, tasks or ISRs on either core, and one reader
+*
+* Writers claim a position with a compare-and-swap on head and publish the slot through its
+* sequence number, so neither side takes a lock or masks interrupts. When the ring is full the
+* new event is dropped and counted, the events already recorded are kept. Counters are accessed
+* with the __atomic builtins, so the structure stays plain C.
+*/
+typedef struct {
+    ir_trace_slot_t *slots;    /*!< Ring storage */
+    uint32_t mask;             /*!< Number of slots minus one */
+    uint32_t head;             /*!< Next position to write */
+    uint32_t tail;             /*!< Next position to read, reader only */
+    uint32_t dropped;          /*!< Events lost because the ring was full */
+} ir_trace_t;
+
+/**
+* @brief Set up an empty trace in caller provided storage
+*
+* @param[out] trace: Trace
+* @param[in] slots: Ring storage, must outlive the trace
+* @param[in] num_slots: Number of slots, a power of 2
+*
+* @return
+*      - ESP_OK: Init trace successfully
+*      - ESP_ERR_INVALID_ARG: Init trace failed because of invalid arguments
+*/
+esp_err_t ir_trace_init(ir_trace_t *trace, ir_trace_slot_t *slots, uint32_t num_slots);
+
+/**
+* @brief Record an event, from any task or ISR
+*
+* Events of concurrent writers may be recorded slightly out of timestamp order.
+*
+* @param[in] trace: Trace, NULL to record nothing
+* @param[in] event: Event
+* @param[in] channel: Channel or receiver of the event
+* @param[in] payload: Value of the event
+*/
+void ir_trace_record(ir_trace_t *trace, ir_trace_event_t event, uint32_t channel, uint32_t payload);
+
+/**
+* @brief Read the oldest event, from the single reader of the trace
+*
+* An event still being written by an interrupted writer ends the read until it is published.
+*
+* @param[in] trace: Trace
+* @param[out] record: Oldest event
+*
+* @return
+*      - ESP_OK: Read event successfully
+*      - ESP_ERR_INVALID_ARG: Read event failed because of invalid arguments
+*      - ESP_ERR_NOT_FOUND: No event ready
+*/
+esp_err_t ir_trace_read(ir_trace_t *trace, ir_trace_record_t *record);
+
+/**
+* @brief Get the number of events dropped because the ring was full
+*
+* @param[in] trace: Trace
+*
+* @return Events dropped since ir_trace_init
+*/
+uint32_t ir_trace_get_dropped(const ir_trace_t *trace);
+
+/**
+* @brief Get the name of an event, for logging
+*
+* @param[in] event: Event
+*
+* @return Name of the event, "unknown" for an invalid one
+*/
+const char *ir_trace_event_name(ir_trace_event_t event);
+
+#ifdef __cplusplus
+}
+#endif
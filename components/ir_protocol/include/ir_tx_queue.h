@@ -0,0 +1,173 @@
+// Copyright 2019 Espressif Systems (Shanghai) PTE LTD
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "esp_err.h"
+
+#define IR_TX_QUEUE_DEPTH (16) /*!< Commands waiting for transmission, at most one per unit */
+#define IR_TX_QUEUE_UNITS (16) /*!< Units whose last transmitted command is remembered */
+
+/**
+* @brief Command waiting for transmission
+*
+*/
+typedef struct {
+    uint32_t unit;     /*!< Unit the command is for; a newer command to the same unit replaces a pending one */
+    uint32_t address;  /*!< Address of the frame */
+    uint32_t command;  /*!< Command of the frame */
+    uint8_t priority;  /*!< Higher priorities are sent first, equal priorities in enqueue order */
+    uint32_t channels; /*!< Bit mask of the owner's TX channels the command goes out on, more than one for a broadcast */
+} ir_tx_command_t;
+
+/**
+* @brief Priority queue of TX commands coalescing commands to the same unit
+*
+* Not thread safe: the owner serializes access (e.g. with a mutex).
+*/
+typedef struct {
+    ir_tx_command_t commands[IR_TX_QUEUE_DEPTH];
+    uint32_t order[IR_TX_QUEUE_DEPTH]; /*!< Enqueue sequence of each command, kept when it is coalesced */
+    uint32_t count;
+    uint32_t sequence;
+    uint32_t coalesced;                /*!< Commands that replaced a pending command to the same unit */
+    ir_tx_command_t sent[IR_TX_QUEUE_UNITS]; /*!< Last command transmitted to each unit */
+    uint32_t sent_count;
+    uint32_t sent_next;                /*!< Entry reused once IR_TX_QUEUE_UNITS units are known */
+    uint32_t skipped;                  /*!< Commands dropped because the unit already has that state */
+} ir_tx_queue_t;
+
+/**
+* @brief Empty a TX queue
+*
+* @param[out] queue: TX queue
+*/
+void ir_tx_queue_init(ir_tx_queue_t *queue);
+
+/**
+* @brief Queue a command, replacing the pending command to the same unit if any
+*
+* A replaced command keeps its place in the queue and the higher of both priorities,
+* so a newer state never waits longer than the one it supersedes; it takes the channels
+* of the newer command.
+*
+* @param[in] queue: TX queue
+* @param[in] command: Command to queue
+* @param[out] coalesced: Set if a pending command was replaced, may be NULL
+*
+* @return
+*      - ESP_OK: Queue command successfully
+*      - ESP_ERR_INVALID_ARG: Queue command failed because of invalid arguments
+*      - ESP_ERR_NO_MEM: Queue command failed because commands to IR_TX_QUEUE_DEPTH other units are pending
+*/
+esp_err_t ir_tx_queue_push(ir_tx_queue_t *queue, const ir_tx_command_t *command, bool *coalesced);
+
+/**
+* @brief Queue a command unless the unit already has that state
+*
+* Commands carrying a full unit state, as aircon remotes send, make a command identical to
+* the last one transmitted to the unit redundant: it is dropped, together with any pending command to
+* the unit, which would otherwise move the unit away from the requested state.
+*
+* @param[in] queue: TX queue
+* @param[in] command: Command to queue
+* @param[out] skipped: Set if the command was dropped, may be NULL
+*
+* @return
+*      - ESP_OK: Queue or drop command successfully
+*      - ESP_ERR_INVALID_ARG: Queue command failed because of invalid arguments
+*      - ESP_ERR_NO_MEM: Queue command failed because commands to IR_TX_QUEUE_DEPTH other units are pending
+*/
+esp_err_t ir_tx_queue_push_changed(ir_tx_queue_t *queue, const ir_tx_command_t *command, bool *skipped);
+
+/**
+* @brief Record a command as transmitted, as reference for ir_tx_queue_push_changed
+*
+* Once IR_TX_QUEUE_UNITS units are known, the oldest recorded unit is forgotten: its next command is
+* always sent.
+*
+* @param[in] queue: TX queue
+* @param[in] command: Command transmitted
+*/
+void ir_tx_queue_mark_sent(ir_tx_queue_t *queue, const ir_tx_command_t *command);
+
+/**
+* @brief Take the command to send next: highest priority, oldest first
+*
+* @param[in] queue: TX queue
+* @param[out] command: Command to send
+*
+* @return
+*      - ESP_OK: Take command successfully
+*      - ESP_ERR_INVALID_ARG: Take command failed because of invalid arguments
+*      - ESP_ERR_NOT_FOUND: Queue is empty
+*/
+esp_err_t ir_tx_queue_pop(ir_tx_queue_t *queue, ir_tx_command_t *command);
+
+/**
+* @brief Take the command to send next among those whose channels are all free
+*
+* Lets an owner driving several channels keep each of them busy: a command waiting for a busy
+* channel does not hold back commands for the others.
+*
+* @param[in] queue: TX queue
+* @param[in] free_channels: Bit mask of the channels free to transmit
+* @param[out] command: Command to send
+*
+* @return
+*      - ESP_OK: Take command successfully
+*      - ESP_ERR_INVALID_ARG: Take command failed because of invalid arguments
+*      - ESP_ERR_NOT_FOUND: No command can go out on the free channels
+*/
+esp_err_t ir_tx_queue_pop_ready(ir_tx_queue_t *queue, uint32_t free_channels, ir_tx_command_t *command);
+
+/**
+* @brief Get the command ir_tx_queue_pop_ready would take, leaving it queued
+*
+* For an owner that may fail to transmit it: the command keeps its place until ir_tx_queue_commit,
+* and a newer command to the unit still replaces it in the meantime.
+*
+* @param[in] queue: TX queue
+* @param[in] free_channels: Bit mask of the channels free to transmit
+* @param[out] command: Command to send
+*
+* @return
+*      - ESP_OK: Get command successfully
+*      - ESP_ERR_INVALID_ARG: Get command failed because of invalid arguments
+*      - ESP_ERR_NOT_FOUND: No command can go out on the free channels
+*/
+esp_err_t ir_tx_queue_peek_ready(const ir_tx_queue_t *queue, uint32_t free_channels, ir_tx_command_t *command);
+
+/**
+* @brief Remove a command got with ir_tx_queue_peek_ready once it is transmitted
+*
+* @param[in] queue: TX queue
+* @param[in] command: Command got with ir_tx_queue_peek_ready
+*
+* @return
+*      - ESP_OK: Remove command successfully
+*      - ESP_ERR_INVALID_ARG: Remove command failed because of invalid arguments
+*      - ESP_ERR_NOT_FOUND: A newer command to the unit replaced it, and stays queued
+*/
+esp_err_t ir_tx_queue_commit(ir_tx_queue_t *queue, const ir_tx_command_t *command);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,569 @@
+// Copyright 2019 Espressif Systems (Shanghai) PTE LTD
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdatomic.h>
+#include <sys/cdefs.h>
+#include "esp_log.h"
+#include "ir_tools.h"
+#include "ir_protocol.h"
+#include "driver/rmt.h"
+
+static const char *TAG = "ir_builder_rmt";
+#define IR_CHECK(a, str, goto_tag, ret_value, ...)                               \
+    do                                                                            \
+    {                                                                             \
+        if (!(a))                                                                 \
+        {                                                                         \
+            ESP_LOGE(TAG, "%s(%d): " str, __FUNCTION__, __LINE__, ##__VA_ARGS__); \
+            ret = ret_value;                                                      \
+            goto goto_tag;                                                        \
+        }                                                                         \
+    } while (0)
+
+#define IR_BUILDER_CACHE_SLOTS IR_BUILDER_RMT_CACHE_SLOTS // built frames kept by build_frame, evicted least recently used first
+#define IR_BUILDER_SCRATCH_SLOT IR_BUILDER_CACHE_SLOTS // slot index of the make_* scratch frame
+#define IR_BUILDER_STREAM_WAIT_MS (1000)   // longest wait of stream_frame for the previous frame, above any aircon frame
+#define IR_BUILDER_MAX_DURATION (0x7FFF)     // rmt_item32_t::duration0/duration1 are 15 bits
+
+// Builder state followed by the scratch frame and one frame per cache slot
+static inline size_t rmt_builder_size(uint32_t buffer_size)
+{
+    return sizeof(ir_rmt_builder_t) + (1 + IR_BUILDER_CACHE_SLOTS) * (size_t)buffer_size * sizeof(rmt_item32_t);
+}
+
+static inline uint32_t rmt_builder_make_item(ir_rmt_builder_t *rmt_builder, uint32_t high_ticks, uint32_t low_ticks)
+{
+    rmt_item32_t item = {
+        .level0 = !rmt_builder->inverse,
+        .duration0 = high_ticks,
+        .level1 = rmt_builder->inverse,
+        .duration1 = low_ticks,
+    };
+    return item.val;
+}
+
+static inline void rmt_builder_put(ir_rmt_builder_t *rmt_builder, uint32_t item)
+{
+    rmt_builder->frame[rmt_builder->cursor].val = item;
+    rmt_builder->cursor += 1;
+}
+
+// Ending code and the idle items holding the rest of a long ending space
+static inline void rmt_builder_put_end(ir_rmt_builder_t *rmt_builder)
+{
+    rmt_builder_put(rmt_builder, rmt_builder->end_item);
+    for (uint32_t i = 0; i < rmt_builder->num_gap_items; i++) {
+        rmt_builder_put(rmt_builder, rmt_builder->gap_items[i]);
+    }
+}
+
+// Bit mask of slots whose items were handed out by get_result and not released yet
+static uint32_t rmt_builder_busy_slots(ir_rmt_builder_t *rmt_builder)
+{
+    uint32_t busy = 0;
+    uint32_t tail = atomic_load_explicit(&rmt_builder->pending_tail, memory_order_relaxed);
+    uint32_t head = atomic_load_explicit(&rmt_builder->pending_head, memory_order_acquire);
+    for (; head != tail; head++) {
+        busy |= 1 << rmt_builder->pending[head % IR_BUILDER_PENDING_DEPTH];
+    }
+    return busy;
+}
+
+static esp_err_t rmt_builder_make_head(ir_builder_t *builder)
+{
+    esp_err_t ret = ESP_OK;
+    ir_rmt_builder_t *rmt_builder = __containerof(builder, ir_rmt_builder_t, parent);
+    IR_CHECK(!(rmt_builder_busy_slots(rmt_builder) & (1 << IR_BUILDER_SCRATCH_SLOT)),
+             "scratch frame still in use", err, ESP_ERR_INVALID_STATE);
+    rmt_builder->frame = rmt_builder->buffer;
+    rmt_builder->frame_slot = IR_BUILDER_SCRATCH_SLOT;
+    rmt_builder->cursor = 0;
+    rmt_builder_put(rmt_builder, rmt_builder->head_item);
+    return ESP_OK;
+err:
+    return ret;
+}
+
+static esp_err_t rmt_builder_make_logic0(ir_builder_t *builder)
+{
+    esp_err_t ret = ESP_OK;
+    ir_rmt_builder_t *rmt_builder = __containerof(builder, ir_rmt_builder_t, parent);
+    // Leave room for the ending code, gap and terminator
+    IR_CHECK(rmt_builder->cursor + 1 + rmt_builder->num_gap_items + 2 <= rmt_builder->buffer_size,
+             "buffer size can't hold more bits", err, ESP_ERR_INVALID_SIZE);
+    rmt_builder_put(rmt_builder, rmt_builder->logic0_item);
+    return ESP_OK;
+err:
+    return ret;
+}
+
+static esp_err_t rmt_builder_make_logic1(ir_builder_t *builder)
+{
+    esp_err_t ret = ESP_OK;
+    ir_rmt_builder_t *rmt_builder = __containerof(builder, ir_rmt_builder_t, parent);
+    IR_CHECK(rmt_builder->cursor + 1 + rmt_builder->num_gap_items + 2 <= rmt_builder->buffer_size,
+             "buffer size can't hold more bits", err, ESP_ERR_INVALID_SIZE);
+    rmt_builder_put(rmt_builder, rmt_builder->logic1_item);
+    return ESP_OK;
+err:
+    return ret;
+}
+
+static esp_err_t rmt_builder_make_end(ir_builder_t *builder)
+{
+    esp_err_t ret = ESP_OK;
+    ir_rmt_builder_t *rmt_builder = __containerof(builder, ir_rmt_builder_t, parent);
+    IR_CHECK(rmt_builder->cursor + 1 + rmt_builder->num_gap_items + 1 <= rmt_builder->buffer_size,
+             "buffer size can't hold the ending code", err, ESP_ERR_INVALID_SIZE);
+    rmt_builder_put_end(rmt_builder);
+    rmt_builder_put(rmt_builder, 0);
+    return ESP_OK;
+err:
+    return ret;
+}
+
+// Expand one payload byte (LSB first) into 8 items with two table copies, no per-bit branching
+static inline void rmt_builder_make_byte(ir_rmt_builder_t *rmt_builder, uint8_t byte)
+{
+    rmt_item32_t *items = &rmt_builder->frame[rmt_builder->cursor];
+    memcpy(&items[0], rmt_builder->nibble_items[byte & 0x0F], sizeof(rmt_builder->nibble_items[0]));
+    memcpy(&items[4], rmt_builder->nibble_items[byte >> 4], sizeof(rmt_builder->nibble_items[0]));
+    rmt_builder->cursor += 8;
+}
+
+// Expand the low bits of a payload field in the protocol's bit order, whole bytes through the nibble table
+static inline void rmt_builder_make_field(ir_rmt_builder_t *rmt_builder, uint32_t value, uint32_t bits)
+{
+    if (!bits) {
+        return;
+    }
+    if (rmt_builder->protocol->flags & IR_PROTOCOL_FLAGS_MSB_FIRST) {
+        value = ir_protocol_reverse_bits(value, bits);
+    }
+    for (; bits >= 8; bits -= 8, value >>= 8) {
+        rmt_builder_make_byte(rmt_builder, value & 0xFF);
+    }
+    for (; bits; bits--, value >>= 1) {
+        rmt_builder_put(rmt_builder, (value & 1) ? rmt_builder->logic1_item : rmt_builder->logic0_item);
+    }
+}
+
+// Each 16-bit half of a field must be a byte followed by its complement
+static inline bool rmt_builder_check_pairs(uint32_t value, uint32_t bits)
+{
+    for (; bits >= 16; bits -= 16, value >>= 16) {
+        if ((value & 0xFF) != (~(value >> 8) & 0xFF)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Return the slot index holding (address, command), or the slot to build it into (free first, then least
+// recently used, never one still in use by the transmitter). Returns -1 if every slot is in use.
+static int rmt_builder_cache_lookup(ir_rmt_builder_t *rmt_builder, uint32_t address, uint32_t command, bool repeated, bool *hit)
+{
+    uint32_t busy = rmt_builder_busy_slots(rmt_builder);
+    int victim = -1;
+    for (int i = 0; i < IR_BUILDER_CACHE_SLOTS; i++) {
+        ir_frame_slot_t *slot = &rmt_builder->cache[i];
+        if (slot->valid && slot->address == address && slot->command == command && slot->repeated == repeated) {
+            *hit = true;
+            return i;
+        }
+        if (busy & (1 << i)) {
+            continue;
+        }
+        if (victim < 0 || (rmt_builder->cache[victim].valid &&
+                           (!slot->valid || slot->last_used < rmt_builder->cache[victim].last_used))) {
+            victim = i;
+        }
+    }
+    *hit = false;
+    return victim;
+}
+
+static inline void rmt_builder_encode(ir_rmt_builder_t *rmt_builder, uint32_t address, uint32_t command)
+{
+    rmt_builder_put(rmt_builder, rmt_builder->head_item);
+    rmt_builder_make_field(rmt_builder, address, rmt_builder->protocol->address_bits);
+    rmt_builder_make_field(rmt_builder, command, rmt_builder->protocol->command_bits);
+    rmt_builder_put_end(rmt_builder);
+}
+
+// Make (address, command) the current result, from the cache or encoded into a free slot
+static esp_err_t rmt_builder_load(ir_rmt_builder_t *rmt_builder, uint32_t address, uint32_t command, bool repeated)
+{
+    esp_err_t ret = ESP_OK;
+    bool hit = false;
+    int slot_index = rmt_builder_cache_lookup(rmt_builder, address, command, repeated, &hit);
+    IR_CHECK(slot_index >= 0, "all frame slots are still in use", err, ESP_ERR_INVALID_STATE);
+    ir_frame_slot_t *slot = &rmt_builder->cache[slot_index];
+    slot->last_used = ++rmt_builder->cache_clock;
+    rmt_builder->frame = slot->items;
+    rmt_builder->frame_slot = slot_index;
+    if (hit) {
+        rmt_builder->cache_hits++;
+        rmt_builder->cursor = slot->length;
+        return ESP_OK;
+    }
+    rmt_builder->cache_misses++;
+    rmt_builder->cursor = 0;
+    rmt_builder_encode(rmt_builder, address, command);
+    if (repeated) {
+        // The ending space of the first frame is the gap, the RMT times it while the CPU does something else
+        rmt_builder_encode(rmt_builder, address, command);
+    }
+    rmt_builder_put(rmt_builder, 0);
+    slot->address = address;
+    slot->command = command;
+    slot->repeated = repeated;
+    slot->length = rmt_builder->cursor;
+    slot->valid = true;
+    return ESP_OK;
+err:
+    return ret;
+}
+
+// Encode (address, command) once, or twice with the gap in between, into a single slot
+static esp_err_t rmt_builder_build(ir_rmt_builder_t *rmt_builder, uint32_t address, uint32_t command, bool repeated)
+{
+    esp_err_t ret = ESP_OK;
+    const ir_protocol_t *protocol = rmt_builder->protocol;
+    if (!(rmt_builder->flags & IR_TOOLS_FLAGS_PROTO_EXT) && (protocol->flags & IR_PROTOCOL_FLAGS_INVERSE_PAIRS)) {
+        IR_CHECK(rmt_builder_check_pairs(address, protocol->address_bits), "address not match standard %s protocol", err,
+                 ESP_ERR_INVALID_ARG, protocol->name);
+        IR_CHECK(rmt_builder_check_pairs(command, protocol->command_bits), "command not match standard %s protocol", err,
+                 ESP_ERR_INVALID_ARG, protocol->name);
+    }
+    if (repeated) {
+        IR_CHECK(rmt_builder->ticks.ending_code_low_ticks, "%s frames have no gap to repeat after", err, ESP_ERR_NOT_SUPPORTED,
+                 protocol->name);
+        IR_CHECK(2 * rmt_builder->frame_items + 1 <= rmt_builder->buffer_size, "buffer size can't hold a repeated frame", err,
+                 ESP_ERR_INVALID_SIZE);
+    }
+    ret = rmt_builder_load(rmt_builder, address, command, repeated);
+    if (ret == ESP_OK) {
+        rmt_builder->last_address = address;
+        rmt_builder->last_command = command;
+        rmt_builder->last_valid = true;
+    }
+    return ret;
+err:
+    return ret;
+}
+
+static esp_err_t rmt_build_frame(ir_builder_t *builder, uint32_t address, uint32_t command)
+{
+    return rmt_builder_build(__containerof(builder, ir_rmt_builder_t, parent), address, command, false);
+}
+
+// Turn the frame of the last build_frame into frame, gap, repeated frame: one result, one rmt_write_items
+static esp_err_t rmt_build_repeat_frame(ir_builder_t *builder)
+{
+    esp_err_t ret = ESP_OK;
+    ir_rmt_builder_t *rmt_builder = __containerof(builder, ir_rmt_builder_t, parent);
+    IR_CHECK(rmt_builder->last_valid, "no frame built to repeat", err, ESP_ERR_INVALID_STATE);
+    return rmt_builder_build(rmt_builder, rmt_builder->last_address, rmt_builder->last_command, true);
+err:
+    return ret;
+}
+
+esp_err_t ir_builder_rmt_build_repeated_frame(ir_builder_t *builder, uint32_t address, uint32_t command)
+{
+    esp_err_t ret = ESP_OK;
+    IR_CHECK(builder, "builder can't be null", err, ESP_ERR_INVALID_ARG);
+    return rmt_builder_build(__containerof(builder, ir_rmt_builder_t, parent), address, command, true);
+err:
+    return ret;
+}
+
+static esp_err_t rmt_builder_get_result(ir_builder_t *builder, void *result, size_t *length)
+{
+    esp_err_t ret = ESP_OK;
+    ir_rmt_builder_t *rmt_builder = __containerof(builder, ir_rmt_builder_t, parent);
+    IR_CHECK(result && length, "result and length can't be null", err, ESP_ERR_INVALID_ARG);
+    if (rmt_builder->flags & IR_TOOLS_FLAGS_TX_RELEASE) {
+        uint32_t tail = atomic_load_explicit(&rmt_builder->pending_tail, memory_order_relaxed);
+        uint32_t head = atomic_load_explicit(&rmt_builder->pending_head, memory_order_acquire);
+        IR_CHECK(tail - head < IR_BUILDER_PENDING_DEPTH, "too many results waiting for release", err, ESP_ERR_INVALID_STATE);
+        rmt_builder->pending[tail % IR_BUILDER_PENDING_DEPTH] = rmt_builder->frame_slot;
+        atomic_store_explicit(&rmt_builder->pending_tail, tail + 1, memory_order_release);
+    }
+    *(rmt_item32_t **)result = rmt_builder->frame;
+    *length = rmt_builder->cursor;
+    return ESP_OK;
+err:
+    return ret;
+}
+
+esp_err_t ir_builder_rmt_release_result(ir_builder_t *builder)
+{
+    // Called from the TX end ISR: no logging here
+    ir_rmt_builder_t *rmt_builder = __containerof(builder, ir_rmt_builder_t, parent);
+    uint32_t head = atomic_load_explicit(&rmt_builder->pending_head, memory_order_relaxed);
+    uint32_t tail = atomic_load_explicit(&rmt_builder->pending_tail, memory_order_acquire);
+    if (head == tail) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    atomic_store_explicit(&rmt_builder->pending_head, head + 1, memory_order_release);
+    return ESP_OK;
+}
+
+esp_err_t ir_builder_rmt_get_cache_stats(ir_builder_t *builder, uint32_t *hits, uint32_t *misses)
+{
+    esp_err_t ret = ESP_OK;
+    IR_CHECK(builder && hits && misses, "builder, hits and misses can't be null", err, ESP_ERR_INVALID_ARG);
+    ir_rmt_builder_t *rmt_builder = __containerof(builder, ir_rmt_builder_t, parent);
+    *hits = rmt_builder->cache_hits;
+    *misses = rmt_builder->cache_misses;
+    return ESP_OK;
+err:
+    return ret;
+}
+
+esp_err_t ir_builder_rmt_get_flags(ir_builder_t *builder, uint32_t *flags)
+{
+    esp_err_t ret = ESP_OK;
+    IR_CHECK(builder && flags, "builder and flags can't be null", err, ESP_ERR_INVALID_ARG);
+    ir_rmt_builder_t *rmt_builder = __containerof(builder, ir_rmt_builder_t, parent);
+    *flags = rmt_builder->flags;
+    return ESP_OK;
+err:
+    return ret;
+}
+
+// Translator of rmt_write_sample: the driver asks for wanted_num items each time channel RAM needs refilling,
+// so frames of any length go out without being materialized. The driver ends the transmission after any
+// fill of fewer than wanted_num items, so every call fills exactly wanted_num until the frame is out: bytes
+// and the ending code and gap are split across calls. A byte is consumed once its 8 items are out, the last
+// one only once the ending code and gap are out too, since the driver stops asking when no byte is left.
+static void rmt_builder_translate(const void *src, rmt_item32_t *dest, size_t src_size, size_t wanted_num,
+                                  size_t *translated_size, size_t *item_num)
+{
+    void *context = NULL;
+    size_t consumed = 0;
+    size_t items = 0;
+    if (rmt_translator_get_context(item_num, &context) != ESP_OK || !context) {
+        *translated_size = 0;
+        *item_num = 0;
+        return;
+    }
+    ir_rmt_builder_t *rmt_builder = (ir_rmt_builder_t *)context;
+    const uint8_t *bytes = (const uint8_t *)src;
+    bool msb_first = rmt_builder->protocol->flags & IR_PROTOCOL_FLAGS_MSB_FIRST;
+    if (!rmt_builder->stream_head_sent && items < wanted_num) {
+        dest[items++].val = rmt_builder->head_item;
+        rmt_builder->stream_head_sent = true;
+    }
+    while (consumed < src_size && items < wanted_num) {
+        uint8_t byte = msb_first ? ir_protocol_reverse_bits(bytes[consumed], 8) : bytes[consumed];
+        uint32_t bit = rmt_builder->stream_bit;
+        if (!bit && items + 8 <= wanted_num) {
+            memcpy(&dest[items], rmt_builder->nibble_items[byte & 0x0F], sizeof(rmt_builder->nibble_items[0]));
+            memcpy(&dest[items + 4], rmt_builder->nibble_items[byte >> 4], sizeof(rmt_builder->nibble_items[0]));
+            items += 8;
+            bit = 8;
+        }
+        for (; bit < 8 && items < wanted_num; bit++) {
+            dest[items++].val = rmt_builder->nibble_items[(byte >> (bit & 4)) & 0x0F][bit & 3];
+        }
+        rmt_builder->stream_bit = bit;
+        if (bit < 8) {
+            break;
+        }
+        if (consumed + 1 == src_size) {
+            uint32_t tail = rmt_builder->stream_tail;
+            for (; tail <= rmt_builder->num_gap_items && items < wanted_num; tail++) {
+                dest[items++].val = tail ? rmt_builder->gap_items[tail - 1] : rmt_builder->end_item;
+            }
+            rmt_builder->stream_tail = tail;
+            if (tail <= rmt_builder->num_gap_items) {
+                break;
+            }
+        }
+        rmt_builder->stream_bit = 0;
+        consumed++;
+    }
+    *translated_size = consumed;
+    *item_num = items;
+}
+
+esp_err_t ir_builder_rmt_stream_frame(ir_builder_t *builder, const uint8_t *data, size_t length, bool wait_tx_done)
+{
+    esp_err_t ret = ESP_OK;
+    IR_CHECK(builder && data && length, "builder and data can't be null or empty", err, ESP_ERR_INVALID_ARG);
+    ir_rmt_builder_t *rmt_builder = __containerof(builder, ir_rmt_builder_t, parent);
+    if (!rmt_builder->stream_installed) {
+        IR_CHECK(rmt_translator_init(rmt_builder->channel, rmt_builder_translate) == ESP_OK,
+                 "install rmt translator failed", err, ESP_FAIL);
+        IR_CHECK(rmt_translator_set_context(rmt_builder->channel, rmt_builder) == ESP_OK,
+                 "set rmt translator context failed", err, ESP_FAIL);
+        rmt_builder->stream_installed = true;
+    }
+    // The translator state belongs to the frame on air until it is out: wait for it a bounded time only if
+    // the caller is willing to block, otherwise refuse the frame while the previous one is still being sent
+    TickType_t wait_time = wait_tx_done ? pdMS_TO_TICKS(IR_BUILDER_STREAM_WAIT_MS) : 0;
+    IR_CHECK(rmt_wait_tx_done(rmt_builder->channel, wait_time) == ESP_OK, "previous frame still on air", err, ESP_ERR_TIMEOUT);
+    rmt_builder->stream_head_sent = false;
+    rmt_builder->stream_bit = 0;
+    rmt_builder->stream_tail = 0;
+    return rmt_write_sample(rmt_builder->channel, data, length, wait_tx_done);
+err:
+    return ret;
+}
+
+static esp_err_t rmt_builder_del(ir_builder_t *builder)
+{
+    ir_rmt_builder_t *rmt_builder = __containerof(builder, ir_rmt_builder_t, parent);
+    free(rmt_builder);
+    return ESP_OK;
+}
+
+// Storage belongs to the caller of ir_builder_rmt_new_static
+static esp_err_t rmt_builder_del_static(ir_builder_t *builder)
+{
+    (void)builder; // storage belongs to the caller
+    return ESP_OK;
+}
+
+// Split the ending space over the ending code item and as many idle items as needed.
+// Both halves of an item are non-zero: a zero duration would end the transmission there.
+static esp_err_t rmt_builder_make_end_items(ir_rmt_builder_t *rmt_builder, uint32_t high_ticks, uint32_t low_ticks)
+{
+    rmt_item32_t idle = {
+        .level0 = rmt_builder->inverse,
+        .level1 = rmt_builder->inverse,
+    };
+    if (low_ticks <= IR_BUILDER_MAX_DURATION) {
+        rmt_builder->end_item = rmt_builder_make_item(rmt_builder, high_ticks, low_ticks);
+        return ESP_OK;
+    }
+    rmt_builder->end_item = rmt_builder_make_item(rmt_builder, high_ticks, IR_BUILDER_MAX_DURATION - 1);
+    uint32_t rest = low_ticks - (IR_BUILDER_MAX_DURATION - 1);
+    while (rest) {
+        if (rmt_builder->num_gap_items == IR_BUILDER_MAX_GAP_ITEMS) {
+            return ESP_ERR_INVALID_SIZE;
+        }
+        // Never leave a single tick for the next item
+        uint32_t chunk = rest <= 2 * IR_BUILDER_MAX_DURATION ? rest :
+                         (rest - 2 * IR_BUILDER_MAX_DURATION >= 2 ? 2 * IR_BUILDER_MAX_DURATION : 2 * IR_BUILDER_MAX_DURATION - 2);
+        idle.duration0 = (chunk + 1) / 2;
+        idle.duration1 = chunk / 2;
+        rmt_builder->gap_items[rmt_builder->num_gap_items++] = idle.val;
+        rest -= chunk;
+    }
+    return ESP_OK;
+}
+
+// Set up zeroed builder storage, everything but del
+static esp_err_t rmt_builder_init(ir_rmt_builder_t *rmt_builder, const ir_builder_config_t *config, const ir_protocol_t *protocol)
+{
+    esp_err_t ret = ESP_OK;
+    IR_CHECK(protocol->address_bits <= 32 && protocol->command_bits <= 32, "%s payload fields wider than 32 bits", err,
+             ESP_ERR_INVALID_ARG, protocol->name);
+
+    rmt_builder->buffer_size = config->buffer_size;
+    rmt_builder->frame = rmt_builder->buffer;
+    rmt_builder->frame_slot = IR_BUILDER_SCRATCH_SLOT;
+    atomic_init(&rmt_builder->pending_head, 0);
+    atomic_init(&rmt_builder->pending_tail, 0);
+    for (int i = 0; i < IR_BUILDER_CACHE_SLOTS; i++) {
+        rmt_builder->cache[i].items = rmt_builder->buffer + (1 + i) * config->buffer_size;
+    }
+    rmt_builder->protocol = protocol;
+    rmt_builder->channel = (rmt_channel_t)config->dev_hdl;
+    rmt_builder->flags = config->flags;
+    if (config->flags & IR_TOOLS_FLAGS_INVERSE) {
+        rmt_builder->inverse = true;
+    }
+
+    uint32_t counter_clk_hz = 0;
+    IR_CHECK(rmt_get_counter_clock((rmt_channel_t)config->dev_hdl, &counter_clk_hz) == ESP_OK,
+             "get rmt counter clock failed", err, ESP_FAIL);
+    IR_CHECK(ir_protocol_get_ticks(protocol, counter_clk_hz, &rmt_builder->ticks) == ESP_OK,
+             "unsupported rmt counter clock", err, ESP_ERR_NOT_SUPPORTED);
+    const ir_timing_ticks_t *ticks = &rmt_builder->ticks;
+    IR_CHECK((ticks->leading_code_high_ticks | ticks->leading_code_low_ticks | ticks->payload_logic0_high_ticks |
+              ticks->payload_logic0_low_ticks | ticks->payload_logic1_high_ticks | ticks->payload_logic1_low_ticks |
+              ticks->ending_code_high_ticks) <= IR_BUILDER_MAX_DURATION,
+             "%s timings don't fit in rmt items at %u Hz", err, ESP_ERR_NOT_SUPPORTED, protocol->name, counter_clk_hz);
+    rmt_builder->head_item = rmt_builder_make_item(rmt_builder, ticks->leading_code_high_ticks, ticks->leading_code_low_ticks);
+    rmt_builder->logic0_item = rmt_builder_make_item(rmt_builder, ticks->payload_logic0_high_ticks, ticks->payload_logic0_low_ticks);
+    rmt_builder->logic1_item = rmt_builder_make_item(rmt_builder, ticks->payload_logic1_high_ticks, ticks->payload_logic1_low_ticks);
+    IR_CHECK(rmt_builder_make_end_items(rmt_builder, ticks->ending_code_high_ticks, ticks->ending_code_low_ticks) == ESP_OK,
+             "%s ending space too long", err, ESP_ERR_NOT_SUPPORTED, protocol->name);
+    // leading code + payload bits + ending code and gap + terminator
+    rmt_builder->frame_items = IR_PROTOCOL_FRAME_ITEMS(protocol) + rmt_builder->num_gap_items;
+    IR_CHECK(config->buffer_size >= rmt_builder->frame_items + 1, "buffer size can't hold a frame", err, ESP_ERR_INVALID_SIZE);
+    for (int nibble = 0; nibble < 16; nibble++) {
+        for (int bit = 0; bit < 4; bit++) {
+            rmt_builder->nibble_items[nibble][bit] = (nibble & (1 << bit)) ? rmt_builder->logic1_item : rmt_builder->logic0_item;
+        }
+    }
+    rmt_builder->parent.make_head = rmt_builder_make_head;
+    rmt_builder->parent.make_logic0 = rmt_builder_make_logic0;
+    rmt_builder->parent.make_logic1 = rmt_builder_make_logic1;
+    rmt_builder->parent.make_end = rmt_builder_make_end;
+    rmt_builder->parent.build_frame = rmt_build_frame;
+    rmt_builder->parent.build_repeat_frame = rmt_build_repeat_frame;
+    rmt_builder->parent.get_result = rmt_builder_get_result;
+    rmt_builder->parent.repeat_period_ms = protocol->repeat_period_ms;
+    return ESP_OK;
+err:
+    return ret;
+}
+
+ir_builder_t *ir_builder_rmt_new(const ir_builder_config_t *config, const ir_protocol_t *protocol)
+{
+    ir_builder_t *ret = NULL;
+    IR_CHECK(config && protocol, "configuration and protocol can't be null", err, NULL);
+    ir_rmt_builder_t *rmt_builder = calloc(1, rmt_builder_size(config->buffer_size));
+    IR_CHECK(rmt_builder, "request memory for rmt_builder failed", err, NULL);
+    if (rmt_builder_init(rmt_builder, config, protocol) != ESP_OK) {
+        free(rmt_builder);
+        return NULL;
+    }
+    rmt_builder->parent.del = rmt_builder_del;
+    return &rmt_builder->parent;
+err:
+    return ret;
+}
+
+ir_builder_t *ir_builder_rmt_new_static(const ir_builder_config_t *config, const ir_protocol_t *protocol, void *storage,
+                                        size_t storage_size)
+{
+    ir_builder_t *ret = NULL;
+    IR_CHECK(config && protocol && storage, "configuration, protocol and storage can't be null", err, NULL);
+    size_t builder_size = rmt_builder_size(config->buffer_size);
+    IR_CHECK(storage_size >= builder_size, "storage of %u bytes can't hold %u", err, NULL, (unsigned)storage_size,
+             (unsigned)builder_size);
+    IR_CHECK(!((uintptr_t)storage % _Alignof(ir_rmt_builder_t)), "storage not aligned", err, NULL);
+    memset(storage, 0, builder_size);
+    ir_rmt_builder_t *rmt_builder = (ir_rmt_builder_t *)storage;
+    if (rmt_builder_init(rmt_builder, config, protocol) != ESP_OK) {
+        return NULL;
+    }
+    rmt_builder->parent.del = rmt_builder_del_static;
+    return &rmt_builder->parent;
+err:
+    return ret;
+}
+
+ir_builder_t *ir_builder_rmt_new_samsung(const ir_builder_config_t *config)
+{
+    return ir_builder_rmt_new(config, &ir_protocol_samsung);
+}
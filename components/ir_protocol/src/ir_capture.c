@@ -0,0 +1,111 @@
+// Copyright 2019 Espressif Systems (Shanghai) PTE LTD
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include <assert.h>
+#include <string.h>
+#include "ir_capture.h"
+
+static_assert(sizeof(ir_capture_header_t) == 16, "capture header layout is part of the file format");
+static_assert(sizeof(ir_capture_record_t) == 8, "record header layout is part of the file format");
+static_assert(sizeof(rmt_item32_t) == 4, "items are stored as their 32-bit value");
+
+esp_err_t ir_capture_writer_init(ir_capture_writer_t *writer, void *buffer, size_t capacity, uint32_t counter_clk_hz)
+{
+    if (!writer || !buffer || !counter_clk_hz) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (capacity < sizeof(ir_capture_header_t)) {
+        return ESP_ERR_NO_MEM;
+    }
+    ir_capture_header_t header = {
+        .magic = IR_CAPTURE_MAGIC,
+        .version = IR_CAPTURE_VERSION,
+        .counter_clk_hz = counter_clk_hz,
+        .records = 0,
+    };
+    memcpy(buffer, &header, sizeof(header));
+    writer->buffer = buffer;
+    writer->capacity = capacity;
+    writer->length = sizeof(header);
+    writer->last_us = 0;
+    return ESP_OK;
+}
+
+esp_err_t ir_capture_write(ir_capture_writer_t *writer, int64_t timestamp_us, const rmt_item32_t *items, uint32_t num_items)
+{
+    if (!writer || (!items && num_items)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    size_t items_size = (size_t)num_items * sizeof(rmt_item32_t);
+    if (writer->capacity - writer->length < sizeof(ir_capture_record_t) + items_size) {
+        return ESP_ERR_NO_MEM;
+    }
+    ir_capture_header_t *header = (ir_capture_header_t *)writer->buffer;
+    int64_t delta_us = header->records ? timestamp_us - writer->last_us : 0;
+    ir_capture_record_t record = {
+        .delta_us = delta_us < 0 ? 0 : delta_us > UINT32_MAX ? UINT32_MAX : (uint32_t)delta_us,
+        .num_items = num_items,
+    };
+    memcpy(writer->buffer + writer->length, &record, sizeof(record));
+    memcpy(writer->buffer + writer->length + sizeof(record), items, items_size);
+    writer->length += sizeof(record) + items_size;
+    writer->last_us = timestamp_us;
+    header->records++;
+    return ESP_OK;
+}
+
+esp_err_t ir_capture_reader_init(ir_capture_reader_t *reader, const void *data, size_t size)
+{
+    if (!reader || !data) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (size < sizeof(ir_capture_header_t)) {
+        return ESP_ERR_INVALID_VERSION;
+    }
+    memcpy(&reader->header, data, sizeof(reader->header));
+    if (reader->header.magic != IR_CAPTURE_MAGIC || reader->header.version != IR_CAPTURE_VERSION ||
+            !reader->header.counter_clk_hz) {
+        return ESP_ERR_INVALID_VERSION;
+    }
+    reader->data = data;
+    reader->size = size;
+    reader->offset = sizeof(ir_capture_header_t);
+    reader->record = 0;
+    reader->timestamp_us = 0;
+    return ESP_OK;
+}
+
+esp_err_t ir_capture_read(ir_capture_reader_t *reader, int64_t *timestamp_us, const rmt_item32_t **items, uint32_t *num_items)
+{
+    if (!reader || !timestamp_us || !items || !num_items) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (reader->record == reader->header.records) {
+        return ESP_ERR_NOT_FOUND;
+    }
+    ir_capture_record_t record;
+    if (reader->size - reader->offset < sizeof(record)) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+    memcpy(&record, reader->data + reader->offset, sizeof(record));
+    if ((reader->size - reader->offset - sizeof(record)) / sizeof(rmt_item32_t) < record.num_items) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+    reader->timestamp_us += record.delta_us;
+    *timestamp_us = reader->timestamp_us;
+    *items = (const rmt_item32_t *)(reader->data + reader->offset + sizeof(record));
+    *num_items = record.num_items;
+    reader->offset += sizeof(record) + (size_t)record.num_items * sizeof(rmt_item32_t);
+    reader->record++;
+    return ESP_OK;
+}
@@ -0,0 +1,103 @@
+// Copyright 2019 Espressif Systems (Shanghai) PTE LTD
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include "ir_filter.h"
+
+#define IR_FILTER_MAX_DURATION (0x7FFF)
+
+// Fields of rmt_item32_t.val: duration0 in bits 0-14, level0 in bit 15, duration1 and level1 above
+#define IR_FILTER_DURATION(val, half) (((val) >> (16 * (half))) & IR_FILTER_MAX_DURATION)
+#define IR_FILTER_LEVEL(val, half) (((val) >> (16 * (half) + 15)) & 1)
+
+// Levels are read and written as a sequence, two per item. The write position never passes the read position
+static inline void ir_filter_put(rmt_item32_t *items, size_t index, uint32_t level, uint32_t duration)
+{
+    uint32_t shift = 16 * (index & 1);
+    duration = duration > IR_FILTER_MAX_DURATION ? IR_FILTER_MAX_DURATION : duration;
+    items[index / 2].val = (items[index / 2].val & ~(0xFFFFu << shift)) | ((level << 15 | duration) << shift);
+}
+
+esp_err_t ir_filter_glitches(rmt_item32_t *items, size_t *num_items, uint32_t glitch_ticks, uint32_t *glitches)
+{
+    if (!items || !num_items) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    size_t length = *num_items;
+    if (glitches) {
+        *glitches = 0;
+    }
+    // Clean data is the common case: find the first glitch without writing anything
+    size_t first = 0;
+    while (first < length && IR_FILTER_DURATION(items[first].val, 0) >= glitch_ticks &&
+            IR_FILTER_DURATION(items[first].val, 1) >= glitch_ticks) {
+        first++;
+    }
+    // The last level may be the 0 the receiver ends its data with
+    if (first == length || (first == length - 1 && IR_FILTER_DURATION(items[first].val, 0) >= glitch_ticks &&
+                            !IR_FILTER_DURATION(items[first].val, 1))) {
+        return ESP_OK;
+    }
+    // Continue from the level before it, everything up to there stays as it is
+    size_t written = first ? 2 * first - 1 : 0;
+    uint32_t removed = 0;
+    uint32_t level = first ? IR_FILTER_LEVEL(items[first - 1].val, 1) : 0;
+    // Duration of the level being assembled, 0 while there is none
+    uint32_t duration = first ? IR_FILTER_DURATION(items[first - 1].val, 1) : 0;
+    uint32_t unmerged = 0;  // its duration before the last glitch merged into it
+    bool merge_next = false; // the next level continues the one being assembled
+    bool skip_next = false;  // the next level is the gap after a leading glitch
+    for (size_t i = 2 * first; i < 2 * length; i++) {
+        uint32_t val = items[i / 2].val;
+        uint32_t next_level = IR_FILTER_LEVEL(val, i & 1);
+        uint32_t next_duration = IR_FILTER_DURATION(val, i & 1);
+        if (!next_duration) {
+            break;
+        }
+        if (skip_next) {
+            skip_next = false;
+        } else if (merge_next) {
+            duration += next_duration;
+            merge_next = false;
+        } else if (next_duration < glitch_ticks) {
+            removed++;
+            if (duration) {
+                unmerged = duration;
+                duration += next_duration;
+                merge_next = true;
+            } else {
+                skip_next = true;
+            }
+        } else {
+            if (duration) {
+                ir_filter_put(items, written++, level, duration);
+            }
+            level = next_level;
+            duration = next_duration;
+        }
+    }
+    if (merge_next) {
+        // Nothing followed the glitch, so it was at the end
+        duration = unmerged;
+    }
+    if (duration) {
+        ir_filter_put(items, written++, level, duration);
+    }
+    if (written & 1) {
+        ir_filter_put(items, written, !level, 0);
+    }
+    *num_items = (written + 1) / 2;
+    if (glitches) {
+        *glitches = removed;
+    }
+    return ESP_OK;
+}
@@ -0,0 +1,79 @@
+// Copyright 2019 Espressif Systems (Shanghai) PTE LTD
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include <string.h>
+#include "esp_log.h"
+#include "esp_rom_sys.h"
+#include "ir_latency.h"
+
+static const char *TAG = "ir_latency";
+
+void ir_latency_init(ir_latency_hist_t *hist)
+{
+    memset(hist, 0, sizeof(*hist));
+    hist->cycles_per_us = esp_rom_get_cpu_ticks_per_us();
+    hist->unit_shift = hist->cycles_per_us > 1 ? 32 - __builtin_clz(hist->cycles_per_us - 1) : 0;
+}
+
+void ir_latency_add(ir_latency_hist_t *hist, uint32_t cycles)
+{
+    uint32_t units = cycles >> hist->unit_shift;
+    uint32_t bucket = units ? 32 - __builtin_clz(units) : 0;
+    hist->buckets[bucket < IR_LATENCY_BUCKETS ? bucket : IR_LATENCY_BUCKETS - 1]++;
+    hist->count++;
+    hist->sum_cycles += cycles;
+    hist->max_cycles = cycles > hist->max_cycles ? cycles : hist->max_cycles;
+}
+
+esp_err_t ir_latency_get_percentile(const ir_latency_hist_t *hist, uint32_t percent, uint32_t *us)
+{
+    if (!hist || !us || !percent || percent > 100 || !hist->cycles_per_us) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (!hist->count) {
+        return ESP_ERR_NOT_FOUND;
+    }
+    uint32_t max_us = (hist->max_cycles + hist->cycles_per_us - 1) / hist->cycles_per_us;
+    uint64_t rank = ((uint64_t)hist->count * percent + 99) / 100;
+    uint64_t seen = 0;
+    for (uint32_t i = 0; i < IR_LATENCY_BUCKETS - 1; i++) {
+        seen += hist->buckets[i];
+        if (seen >= rank) {
+            uint64_t bound_us = (((uint64_t)1 << (i + hist->unit_shift)) + hist->cycles_per_us - 1) / hist->cycles_per_us;
+            *us = bound_us < max_us ? (uint32_t)bound_us : max_us;
+            return ESP_OK;
+        }
+    }
+    *us = max_us;
+    return ESP_OK;
+}
+
+esp_err_t ir_latency_dump(const ir_latency_hist_t *hist, const char *name)
+{
+    if (!hist || !name) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    uint32_t p50 = 0;
+    uint32_t p90 = 0;
+    uint32_t p99 = 0;
+    if (ir_latency_get_percentile(hist, 50, &p50) != ESP_OK) {
+        ESP_LOGI(TAG, "%s: no samples", name);
+        return ESP_OK;
+    }
+    ir_latency_get_percentile(hist, 90, &p90);
+    ir_latency_get_percentile(hist, 99, &p99);
+    ESP_LOGI(TAG, "%s: %u samples, mean %u us, p50 <= %u us, p90 <= %u us, p99 <= %u us, max %u us", name, hist->count,
+             (uint32_t)(hist->sum_cycles / hist->count / hist->cycles_per_us), p50, p90, p99,
+             (hist->max_cycles + hist->cycles_per_us - 1) / hist->cycles_per_us);
+    return ESP_OK;
+}
@@ -0,0 +1,365 @@
+// Copyright 2019 Espressif Systems (Shanghai) PTE LTD
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/cdefs.h>
+#include "esp_log.h"
+#include "ir_tools.h"
+#include "ir_protocol.h"
+#include "driver/rmt.h"
+
+static const char *TAG = "ir_parser_dispatch";
+#define DISPATCH_CHECK(a, str, goto_tag, ret_value, ...)                              \
+    do                                                                            \
+    {                                                                             \
+        if (!(a))                                                                 \
+        {                                                                         \
+            ESP_LOGE(TAG, "%s(%d): " str, __FUNCTION__, __LINE__, ##__VA_ARGS__); \
+            ret = ret_value;                                                      \
+            goto goto_tag;                                                        \
+        }                                                                         \
+    } while (0)
+
+#define DISPATCH_BUCKETS IR_PARSER_DISPATCH_BUCKETS // buckets per leading code duration, each a mask of the protocols it may belong to
+
+static inline bool dispatch_check_in_range(uint32_t raw_ticks, dispatch_window_t window)
+{
+    return (raw_ticks < window.hi) && (raw_ticks > window.lo);
+}
+
+static inline uint32_t dispatch_bucket_mask(const dispatch_parser_t *dispatch_parser, const uint8_t *buckets, uint32_t ticks)
+{
+    uint32_t index = ticks >> dispatch_parser->bucket_shift;
+    return index < DISPATCH_BUCKETS ? buckets[index] : 0;
+}
+
+// Route whose leading code matches item: two table lookups narrow the candidates, the exact windows decide.
+// Returns -1 if the item is no leading code of any protocol.
+static inline int dispatch_classify(const dispatch_parser_t *dispatch_parser, rmt_item32_t item)
+{
+    if ((item.val & dispatch_parser->level_mask) != dispatch_parser->level_expect) {
+        return -1;
+    }
+    uint32_t candidates = dispatch_bucket_mask(dispatch_parser, dispatch_parser->mark_buckets, item.duration0) &
+                          dispatch_bucket_mask(dispatch_parser, dispatch_parser->space_buckets, item.duration1);
+    while (candidates) {
+        int route = __builtin_ctz(candidates);
+        if (dispatch_check_in_range(item.duration0, dispatch_parser->routes[route].head_mark) &&
+                dispatch_check_in_range(item.duration1, dispatch_parser->routes[route].head_space)) {
+            return route;
+        }
+        candidates &= candidates - 1;
+    }
+    return -1;
+}
+
+// Hand one run of items to the parser of a route
+static void dispatch_route_run(dispatch_parser_t *dispatch_parser, int route, rmt_item32_t *items, uint32_t length,
+                               ir_scan_code_t *codes, uint32_t max_codes, uint32_t *count)
+{
+    ir_parser_t *parser = dispatch_parser->routes[route].parser;
+    if (codes) {
+        uint32_t decoded = 0;
+        parser->decode_batch(parser, items, length, &codes[*count], max_codes - *count, &decoded);
+        *count += decoded;
+    } else {
+        parser->input(parser, items, length);
+    }
+}
+
+// Frames a route decoded so far, repeats and dropped repeats included
+static uint32_t dispatch_route_frames(const dispatch_parser_t *dispatch_parser, int route)
+{
+    ir_parser_stats_t stats;
+    ir_parser_rmt_get_stats(dispatch_parser->routes[route].parser, &stats);
+    return stats.frames;
+}
+
+// Hand items to the protocol parsers in runs: each run starts at a leading code and goes to its protocol.
+// Items before the first leading code continue the frame of the previous call in stream mode.
+// Without codes (stream mode input) the runs are only input, their frames stay queued in the protocol parsers.
+static esp_err_t dispatch_route_runs(dispatch_parser_t *dispatch_parser, rmt_item32_t *items, uint32_t length,
+                                     ir_scan_code_t *codes, uint32_t max_codes, uint32_t *num_codes)
+{
+    uint32_t count = 0;
+    uint32_t start = 0;
+    int route = (dispatch_parser->flags & IR_TOOLS_FLAGS_STREAM) ? dispatch_parser->active : -1;
+    for (uint32_t i = 0; i <= length; i++) {
+        int next = i < length ? dispatch_classify(dispatch_parser, items[i]) : -1;
+        if (i < length && next < 0) {
+            continue;
+        }
+        if (route >= 0 && i > start) {
+            dispatch_route_run(dispatch_parser, route, &items[start], i - start, codes, max_codes, &count);
+        }
+        if (i == length) {
+            break;
+        }
+        route = next;
+        start = i;
+        uint32_t end = i + dispatch_parser->routes[next].frame_items;
+        if (end <= length) {
+            // A whole frame follows its leading code: decode it now, and only if it decoded classify again after
+            // its ending code. A truncated or broken frame may hide the leading code of the next one.
+            uint32_t frames = dispatch_route_frames(dispatch_parser, next);
+            dispatch_route_run(dispatch_parser, next, &items[i], end - i, codes, max_codes, &count);
+            start = end;
+            if (dispatch_route_frames(dispatch_parser, next) != frames) {
+                i = end - 1;
+            }
+        }
+    }
+    if (dispatch_parser->flags & IR_TOOLS_FLAGS_STREAM) {
+        // Last run may be a frame still in progress, it continues with the next call
+        dispatch_parser->active = route >= 0 ? route : dispatch_parser->active;
+        // Drain frames the other protocol parsers completed earlier but could not return for lack of room
+        for (uint32_t r = 0; codes && r < dispatch_parser->num_routes && count < max_codes; r++) {
+            ir_parser_t *parser = dispatch_parser->routes[r].parser;
+            uint32_t decoded = 0;
+            parser->decode_batch(parser, items, 0, &codes[count], max_codes - count, &decoded);
+            count += decoded;
+        }
+    }
+    *num_codes = count;
+    return ESP_OK;
+}
+
+static esp_err_t dispatch_parser_decode_batch(ir_parser_t *parser, void *raw_data, uint32_t length,
+                                              ir_scan_code_t *codes, uint32_t max_codes, uint32_t *num_codes)
+{
+    esp_err_t ret = ESP_OK;
+    dispatch_parser_t *dispatch_parser = __containerof(parser, dispatch_parser_t, parent);
+    DISPATCH_CHECK(raw_data && codes && num_codes, "raw data, codes and num_codes can't be null", err, ESP_ERR_INVALID_ARG);
+    return dispatch_route_runs(dispatch_parser, raw_data, length, codes, max_codes, num_codes);
+err:
+    return ret;
+}
+
+static esp_err_t dispatch_parser_input(ir_parser_t *parser, void *raw_data, uint32_t length)
+{
+    esp_err_t ret = ESP_OK;
+    dispatch_parser_t *dispatch_parser = __containerof(parser, dispatch_parser_t, parent);
+    DISPATCH_CHECK(raw_data, "input data can't be null", err, ESP_ERR_INVALID_ARG);
+    if (dispatch_parser->flags & IR_TOOLS_FLAGS_STREAM) {
+        // Decoded frames stay queued in the protocol parsers until get_scan_code
+        uint32_t num_codes = 0;
+        return dispatch_route_runs(dispatch_parser, raw_data, length, NULL, 0, &num_codes);
+    }
+    dispatch_parser->active = length ? dispatch_classify(dispatch_parser, ((rmt_item32_t *)raw_data)[0]) : -1;
+    if (dispatch_parser->active < 0) {
+        return ESP_FAIL;
+    }
+    ir_parser_t *target = dispatch_parser->routes[dispatch_parser->active].parser;
+    return target->input(target, raw_data, length);
+err:
+    return ret;
+}
+
+static esp_err_t dispatch_parser_get_scan_code(ir_parser_t *parser, uint32_t *address, uint32_t *command, bool *repeat)
+{
+    esp_err_t ret = ESP_FAIL;
+    dispatch_parser_t *dispatch_parser = __containerof(parser, dispatch_parser_t, parent);
+    DISPATCH_CHECK(address && command && repeat, "address, command and repeat can't be null", err, ESP_ERR_INVALID_ARG);
+    if (dispatch_parser->flags & IR_TOOLS_FLAGS_STREAM) {
+        for (uint32_t r = 0; r < dispatch_parser->num_routes; r++) {
+            ir_parser_t *target = dispatch_parser->routes[r].parser;
+            if (target->get_scan_code(target, address, command, repeat) == ESP_OK) {
+                return ESP_OK;
+            }
+        }
+        return ESP_FAIL;
+    }
+    if (dispatch_parser->active >= 0) {
+        ir_parser_t *target = dispatch_parser->routes[dispatch_parser->active].parser;
+        ret = target->get_scan_code(target, address, command, repeat);
+    }
+    return ret;
+err:
+    return ret;
+}
+
+static void dispatch_parser_del_routes(dispatch_parser_t *dispatch_parser)
+{
+    for (uint32_t r = 0; r < dispatch_parser->num_routes; r++) {
+        dispatch_parser->routes[r].parser->del(dispatch_parser->routes[r].parser);
+    }
+}
+
+static esp_err_t dispatch_parser_del(ir_parser_t *parser)
+{
+    dispatch_parser_t *dispatch_parser = __containerof(parser, dispatch_parser_t, parent);
+    dispatch_parser_del_routes(dispatch_parser);
+    free(dispatch_parser);
+    return ESP_OK;
+}
+
+// Storage, including that of the protocol parsers, belongs to the caller of ir_parser_rmt_new_dispatch_static
+static esp_err_t dispatch_parser_del_static(ir_parser_t *parser)
+{
+    dispatch_parser_del_routes(__containerof(parser, dispatch_parser_t, parent));
+    return ESP_OK;
+}
+
+esp_err_t ir_parser_dispatch_get_parser(ir_parser_t *parser, uint32_t index, ir_parser_t **ret_parser)
+{
+    esp_err_t ret = ESP_OK;
+    DISPATCH_CHECK(parser && ret_parser, "parser and ret_parser can't be null", err, ESP_ERR_INVALID_ARG);
+    dispatch_parser_t *dispatch_parser = __containerof(parser, dispatch_parser_t, parent);
+    DISPATCH_CHECK(index < dispatch_parser->num_routes, "no protocol %u", err, ESP_ERR_INVALID_ARG, index);
+    *ret_parser = dispatch_parser->routes[index].parser;
+    return ESP_OK;
+err:
+    return ret;
+}
+
+esp_err_t ir_parser_dispatch_get_stats(ir_parser_t *parser, ir_parser_stats_t *stats)
+{
+    esp_err_t ret = ESP_OK;
+    DISPATCH_CHECK(parser && stats, "parser and stats can't be null", err, ESP_ERR_INVALID_ARG);
+    dispatch_parser_t *dispatch_parser = __containerof(parser, dispatch_parser_t, parent);
+    memset(stats, 0, sizeof(*stats));
+    for (uint32_t i = 0; i < dispatch_parser->num_routes; i++) {
+        ir_parser_stats_t route;
+        ir_parser_rmt_get_stats(dispatch_parser->routes[i].parser, &route);
+        stats->frames += route.frames;
+        stats->head_level += route.head_level;
+        stats->head_mark += route.head_mark;
+        stats->head_space += route.head_space;
+        stats->bit_timing += route.bit_timing;
+        stats->length += route.length;
+        stats->trailer += route.trailer;
+        stats->repeats += route.repeats;
+    }
+    return ESP_OK;
+err:
+    return ret;
+}
+
+static dispatch_window_t dispatch_make_window(uint32_t target_ticks, uint32_t margin_ticks)
+{
+    dispatch_window_t window = {
+        .lo = target_ticks > margin_ticks ? target_ticks - margin_ticks : 0,
+        .hi = target_ticks + margin_ticks,
+    };
+    return window;
+}
+
+// Mark every bucket overlapping (lo, hi) as a candidate of route
+static void dispatch_fill_buckets(uint8_t *buckets, uint32_t shift, dispatch_window_t window, uint32_t route)
+{
+    for (uint32_t b = (window.lo + 1) >> shift; b < DISPATCH_BUCKETS && b <= (window.hi - 1) >> shift; b++) {
+        buckets[b] |= 1 << route;
+    }
+}
+
+// Set up zeroed dispatch parser storage, everything but del. Protocol parsers are allocated unless
+// parser_storage gives room for them, IR_PARSER_RMT_STATIC_SIZE each. Routes created before a failure
+// are in num_routes.
+static esp_err_t dispatch_parser_init(dispatch_parser_t *dispatch_parser, const ir_parser_config_t *config,
+                                      const ir_protocol_t *const *protocols, uint32_t num_protocols, uint8_t *parser_storage)
+{
+    esp_err_t ret = ESP_OK;
+    dispatch_parser->flags = config->flags;
+    dispatch_parser->active = -1;
+    bool inverse = config->flags & IR_TOOLS_FLAGS_INVERSE;
+    rmt_item32_t level_mask = {.level0 = 1, .level1 = 1};
+    rmt_item32_t level_expect = {.level0 = inverse, .level1 = !inverse};
+    dispatch_parser->level_mask = level_mask.val;
+    dispatch_parser->level_expect = level_expect.val;
+
+    uint32_t counter_clk_hz = 0;
+    DISPATCH_CHECK(rmt_get_counter_clock((rmt_channel_t)config->dev_hdl, &counter_clk_hz) == ESP_OK,
+                   "get rmt counter clock failed", err, ESP_FAIL);
+    uint32_t margin_ticks = IR_US_TO_TICKS(config->margin_us, counter_clk_hz);
+    if (config->flags & IR_TOOLS_FLAGS_CALIBRATE) {
+        // Route the leading codes of near misses too, the protocol parsers learn from them
+        margin_ticks *= IR_PARSER_CALIB_LEARN_MARGIN;
+    }
+    uint32_t longest = 0;
+    for (uint32_t r = 0; r < num_protocols; r++) {
+        ir_timing_ticks_t ticks;
+        DISPATCH_CHECK(protocols[r] && ir_protocol_get_ticks(protocols[r], counter_clk_hz, &ticks) == ESP_OK,
+                       "invalid protocol %u", err, ESP_ERR_INVALID_ARG, r);
+        dispatch_route_t *route = &dispatch_parser->routes[r];
+        route->frame_items = IR_PROTOCOL_FRAME_ITEMS(protocols[r]);
+        route->head_mark = dispatch_make_window(ticks.leading_code_high_ticks, margin_ticks);
+        route->head_space = dispatch_make_window(ticks.leading_code_low_ticks, margin_ticks);
+        longest = route->head_mark.hi > longest ? route->head_mark.hi : longest;
+        longest = route->head_space.hi > longest ? route->head_space.hi : longest;
+        uint8_t *storage = parser_storage ? parser_storage + r * IR_PARSER_RMT_STATIC_SIZE : NULL;
+        route->parser = storage ? ir_parser_rmt_new_static(config, protocols[r], storage, IR_PARSER_RMT_STATIC_SIZE) :
+                        ir_parser_rmt_new(config, protocols[r]);
+        DISPATCH_CHECK(route->parser, "create %s parser failed", err, ESP_FAIL, protocols[r]->name);
+        dispatch_parser->num_routes++;
+    }
+    // Smallest bucket width that still covers the longest leading code duration
+    while ((longest >> dispatch_parser->bucket_shift) >= DISPATCH_BUCKETS) {
+        dispatch_parser->bucket_shift++;
+    }
+    for (uint32_t r = 0; r < num_protocols; r++) {
+        dispatch_fill_buckets(dispatch_parser->mark_buckets, dispatch_parser->bucket_shift, dispatch_parser->routes[r].head_mark, r);
+        dispatch_fill_buckets(dispatch_parser->space_buckets, dispatch_parser->bucket_shift, dispatch_parser->routes[r].head_space, r);
+    }
+    dispatch_parser->parent.input = dispatch_parser_input;
+    dispatch_parser->parent.get_scan_code = dispatch_parser_get_scan_code;
+    dispatch_parser->parent.decode_batch = dispatch_parser_decode_batch;
+    return ESP_OK;
+err:
+    return ret;
+}
+
+ir_parser_t *ir_parser_rmt_new_dispatch(const ir_parser_config_t *config, const ir_protocol_t *const *protocols,
+                                        uint32_t num_protocols)
+{
+    ir_parser_t *ret = NULL;
+    DISPATCH_CHECK(config && protocols, "configuration and protocols can't be null", err, NULL);
+    DISPATCH_CHECK(num_protocols && num_protocols <= IR_PARSER_DISPATCH_MAX_PROTOCOLS, "unsupported number of protocols %u",
+                   err, NULL, num_protocols);
+
+    dispatch_parser_t *dispatch_parser = calloc(1, sizeof(dispatch_parser_t));
+    DISPATCH_CHECK(dispatch_parser, "request memory for dispatch_parser failed", err, NULL);
+    dispatch_parser->parent.del = dispatch_parser_del;
+    if (dispatch_parser_init(dispatch_parser, config, protocols, num_protocols, NULL) != ESP_OK) {
+        dispatch_parser_del(&dispatch_parser->parent);
+        return NULL;
+    }
+    return &dispatch_parser->parent;
+err:
+    return ret;
+}
+
+ir_parser_t *ir_parser_rmt_new_dispatch_static(const ir_parser_config_t *config, const ir_protocol_t *const *protocols,
+                                               uint32_t num_protocols, void *storage, size_t storage_size)
+{
+    ir_parser_t *ret = NULL;
+    DISPATCH_CHECK(config && protocols && storage, "configuration, protocols and storage can't be null", err, NULL);
+    DISPATCH_CHECK(num_protocols && num_protocols <= IR_PARSER_DISPATCH_MAX_PROTOCOLS, "unsupported number of protocols %u",
+                   err, NULL, num_protocols);
+    DISPATCH_CHECK(storage_size >= IR_PARSER_DISPATCH_STATIC_SIZE(num_protocols), "storage of %u bytes can't hold %u", err,
+                   NULL, (unsigned)storage_size, (unsigned)IR_PARSER_DISPATCH_STATIC_SIZE(num_protocols));
+    DISPATCH_CHECK(!((uintptr_t)storage % 8), "storage not aligned", err, NULL);
+
+    memset(storage, 0, sizeof(dispatch_parser_t));
+    dispatch_parser_t *dispatch_parser = (dispatch_parser_t *)storage;
+    dispatch_parser->parent.del = dispatch_parser_del_static;
+    if (dispatch_parser_init(dispatch_parser, config, protocols, num_protocols,
+                             (uint8_t *)storage + IR_PARSER_DISPATCH_STATIC_BASE_SIZE) != ESP_OK) {
+        dispatch_parser_del_static(&dispatch_parser->parent);
+        return NULL;
+    }
+    return &dispatch_parser->parent;
+err:
+    return ret;
+}
@@ -0,0 +1,1003 @@
+// Copyright 2019 Espressif Systems (Shanghai) PTE LTD
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdatomic.h>
+#include <sys/cdefs.h>
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "ir_tools.h"
+#include "ir_protocol.h"
+#include "driver/rmt.h"
+
+static const char *TAG = "ir_parser_rmt";
+#define IR_CHECK(a, str, goto_tag, ret_value, ...)                               \
+    do                                                                            \
+    {                                                                             \
+        if (!(a))                                                                 \
+        {                                                                         \
+            ESP_LOGE(TAG, "%s(%d): " str, __FUNCTION__, __LINE__, ##__VA_ARGS__); \
+            ret = ret_value;                                                      \
+            goto goto_tag;                                                        \
+        }                                                                         \
+    } while (0)
+
+#ifndef IR_PARSER_LOG_ERRORS
+#define IR_PARSER_LOG_ERRORS (0) // 1: also log every rejected frame (formatted UART output on the RX path)
+#endif
+
+// Count a rejected frame by reason, optionally logging it
+#if IR_PARSER_LOG_ERRORS
+#define IR_REJECT(parser, reason, format, ...)                                    \
+    do                                                                                \
+    {                                                                                 \
+        atomic_fetch_add_explicit(&(parser)->stats.reason, 1, memory_order_relaxed);  \
+        ESP_LOGW("parser error", format, ##__VA_ARGS__);                              \
+    } while (0)
+#else
+#define IR_REJECT(parser, reason, format, ...) \
+    atomic_fetch_add_explicit(&(parser)->stats.reason, 1, memory_order_relaxed)
+#endif
+
+#define IR_PARSER_CALIB_WEIGHT (8)          // calibration is a running mean over about this many frames
+#define IR_PARSER_CALIB_SETTLE_FRAMES (16)  // frames learned before margins narrow to the observed jitter
+#define IR_PARSER_CALIB_JITTER_MARGIN (4)   // margin in mean deviations, at least a quarter of the configured margin
+
+static inline ir_window_t ir_make_window(uint32_t low_target_ticks, uint32_t high_target_ticks, uint32_t margin_ticks)
+{
+    ir_window_t window = {
+        .lo = low_target_ticks > margin_ticks ? low_target_ticks - margin_ticks : 0,
+        .hi = high_target_ticks + margin_ticks,
+    };
+    return window;
+}
+
+static inline bool ir_check_in_range(uint32_t raw_ticks, ir_window_t window)
+{
+    return (raw_ticks < window.hi) && (raw_ticks > window.lo);
+}
+
+static inline uint32_t ir_min(uint32_t a, uint32_t b)
+{
+    return a < b ? a : b;
+}
+
+static inline uint32_t ir_max(uint32_t a, uint32_t b)
+{
+    return a > b ? a : b;
+}
+
+// Nominal duration a calibration offset applies to, the shorter one for payload durations
+static uint32_t ir_calib_nominal(const ir_rmt_parser_t *rmt_parser, ir_calib_kind_t kind)
+{
+    switch (kind) {
+    case IR_CALIB_HEAD_MARK:
+        return rmt_parser->ticks.leading_code_high_ticks;
+    case IR_CALIB_HEAD_SPACE:
+        return rmt_parser->ticks.leading_code_low_ticks;
+    case IR_CALIB_BIT_MARK:
+        return ir_min(rmt_parser->bit_mark_ticks[0], rmt_parser->bit_mark_ticks[1]);
+    case IR_CALIB_BIT_SPACE:
+        return ir_min(rmt_parser->bit_space_ticks[0], rmt_parser->bit_space_ticks[1]);
+    default:
+        return rmt_parser->ticks.ending_code_high_ticks;
+    }
+}
+
+static inline int32_t ir_calib_offset_ticks(const ir_rmt_parser_t *rmt_parser, ir_calib_kind_t kind)
+{
+    int32_t offset_q4 = rmt_parser->source->calib[kind].offset_q4;
+    return (offset_q4 + (offset_q4 < 0 ? -8 : 8)) / 16;
+}
+
+// Nominal duration moved by the learned offset of its kind
+static inline uint32_t ir_calib_target(const ir_rmt_parser_t *rmt_parser, ir_calib_kind_t kind, uint32_t nominal_ticks)
+{
+    int32_t target = (int32_t)nominal_ticks + ir_calib_offset_ticks(rmt_parser, kind);
+    return target > 0 ? target : 0;
+}
+
+// Acceptance windows and bit threshold from the nominal timing, the learned offsets and margins
+static void ir_parser_apply_timing(ir_rmt_parser_t *rmt_parser)
+{
+    const ir_timing_ticks_t *ticks = &rmt_parser->ticks;
+    const ir_calib_t *calib = rmt_parser->source->calib;
+    uint32_t mark0 = ir_calib_target(rmt_parser, IR_CALIB_BIT_MARK, rmt_parser->bit_mark_ticks[0]);
+    uint32_t mark1 = ir_calib_target(rmt_parser, IR_CALIB_BIT_MARK, rmt_parser->bit_mark_ticks[1]);
+    uint32_t space0 = ir_calib_target(rmt_parser, IR_CALIB_BIT_SPACE, rmt_parser->bit_space_ticks[0]);
+    uint32_t space1 = ir_calib_target(rmt_parser, IR_CALIB_BIT_SPACE, rmt_parser->bit_space_ticks[1]);
+    uint32_t head_mark = ir_calib_target(rmt_parser, IR_CALIB_HEAD_MARK, ticks->leading_code_high_ticks);
+    uint32_t head_space = ir_calib_target(rmt_parser, IR_CALIB_HEAD_SPACE, ticks->leading_code_low_ticks);
+    uint32_t ending_mark = ir_calib_target(rmt_parser, IR_CALIB_ENDING_MARK, ticks->ending_code_high_ticks);
+    rmt_parser->head_mark = ir_make_window(head_mark, head_mark, calib[IR_CALIB_HEAD_MARK].margin_ticks);
+    rmt_parser->head_space = ir_make_window(head_space, head_space, calib[IR_CALIB_HEAD_SPACE].margin_ticks);
+    rmt_parser->bit_mark[0] = ir_make_window(mark0, mark0, calib[IR_CALIB_BIT_MARK].margin_ticks);
+    rmt_parser->bit_mark[1] = ir_make_window(mark1, mark1, calib[IR_CALIB_BIT_MARK].margin_ticks);
+    rmt_parser->bit_space[0] = ir_make_window(space0, space0, calib[IR_CALIB_BIT_SPACE].margin_ticks);
+    rmt_parser->bit_space[1] = ir_make_window(space1, space1, calib[IR_CALIB_BIT_SPACE].margin_ticks);
+    rmt_parser->bit_threshold_ticks = rmt_parser->bit_shift ? (space0 + space1) / 2 : (mark0 + mark1) / 2;
+    rmt_parser->ending_mark = ir_make_window(ending_mark, ending_mark, calib[IR_CALIB_ENDING_MARK].margin_ticks);
+    // Frames that miss the windows are learned from if they fit wider ones spanning the learned and the
+    // nominal timing, so a remote off the other way than the one seen last is learned from too
+    uint32_t learn_margin = IR_PARSER_CALIB_LEARN_MARGIN * rmt_parser->margin_ticks;
+    uint32_t nominal_mark0 = rmt_parser->bit_mark_ticks[0];
+    uint32_t nominal_mark1 = rmt_parser->bit_mark_ticks[1];
+    uint32_t nominal_space0 = rmt_parser->bit_space_ticks[0];
+    uint32_t nominal_space1 = rmt_parser->bit_space_ticks[1];
+    rmt_parser->learn[IR_CALIB_HEAD_MARK] = ir_make_window(ir_min(head_mark, ticks->leading_code_high_ticks),
+                                                           ir_max(head_mark, ticks->leading_code_high_ticks), learn_margin);
+    rmt_parser->learn[IR_CALIB_HEAD_SPACE] = ir_make_window(ir_min(head_space, ticks->leading_code_low_ticks),
+                                                            ir_max(head_space, ticks->leading_code_low_ticks), learn_margin);
+    rmt_parser->learn_bit_mark[0] = ir_make_window(ir_min(mark0, nominal_mark0), ir_max(mark0, nominal_mark0), learn_margin);
+    rmt_parser->learn_bit_mark[1] = ir_make_window(ir_min(mark1, nominal_mark1), ir_max(mark1, nominal_mark1), learn_margin);
+    rmt_parser->learn_bit_space[0] = ir_make_window(ir_min(space0, nominal_space0), ir_max(space0, nominal_space0), learn_margin);
+    rmt_parser->learn_bit_space[1] = ir_make_window(ir_min(space1, nominal_space1), ir_max(space1, nominal_space1), learn_margin);
+    rmt_parser->learn[IR_CALIB_ENDING_MARK] = ir_make_window(ir_min(ending_mark, ticks->ending_code_high_ticks),
+                                                             ir_max(ending_mark, ticks->ending_code_high_ticks), learn_margin);
+}
+
+static inline void ir_calib_add(const ir_rmt_parser_t *rmt_parser, ir_calib_frame_t *frame, ir_calib_kind_t kind,
+                                uint32_t observed_ticks, uint32_t nominal_ticks)
+{
+    int32_t error = (int32_t)observed_ticks - (int32_t)nominal_ticks;
+    int32_t deviation_q4 = error * 16 - rmt_parser->source->calib[kind].offset_q4;
+    frame->error[kind] += error;
+    frame->deviation[kind] += deviation_q4 < 0 ? -deviation_q4 : deviation_q4;
+    frame->count[kind]++;
+}
+
+static inline void ir_calib_add_bit(const ir_rmt_parser_t *rmt_parser, ir_calib_frame_t *frame, rmt_item32_t item, int bit)
+{
+    ir_calib_add(rmt_parser, frame, IR_CALIB_BIT_MARK, item.duration0, rmt_parser->bit_mark_ticks[bit]);
+    ir_calib_add(rmt_parser, frame, IR_CALIB_BIT_SPACE, item.duration1, rmt_parser->bit_space_ticks[bit]);
+}
+
+static inline int32_t ir_calib_step(int32_t mean, int32_t sample, int32_t weight)
+{
+    // Division by a constant once past the first frames, this runs for every decoded frame
+    if (weight == IR_PARSER_CALIB_WEIGHT) {
+        return mean + (sample - mean) / IR_PARSER_CALIB_WEIGHT;
+    }
+    return mean + (sample - mean) / weight;
+}
+
+// Fold the durations of a frame into the running means of its source and move the windows accordingly
+static void ir_calib_learn(ir_rmt_parser_t *rmt_parser, const ir_calib_frame_t *frame)
+{
+    // Plain mean over the first frames, then a running mean
+    int32_t weight = rmt_parser->source->frames < IR_PARSER_CALIB_WEIGHT ? rmt_parser->source->frames + 1 : IR_PARSER_CALIB_WEIGHT;
+    bool settled = ++rmt_parser->source->frames >= IR_PARSER_CALIB_SETTLE_FRAMES;
+    for (int kind = 0; kind < IR_CALIB_MAX; kind++) {
+        ir_calib_t *calib = &rmt_parser->source->calib[kind];
+        if (frame->count[kind]) {
+            int32_t count = frame->count[kind];
+            int32_t error_q4 = frame->error[kind] * 16;
+            int32_t deviation_q4 = frame->deviation[kind];
+            if (count > 1) {
+                error_q4 /= count;
+                deviation_q4 /= count;
+            }
+            // Never further than half the nominal duration, a window can't drift into another kind of duration
+            int32_t limit_q4 = ir_calib_nominal(rmt_parser, kind) * 8;
+            calib->offset_q4 = ir_calib_step(calib->offset_q4, error_q4, weight);
+            calib->offset_q4 = calib->offset_q4 > limit_q4 ? limit_q4 : calib->offset_q4 < -limit_q4 ? -limit_q4 : calib->offset_q4;
+            calib->jitter_q4 = ir_calib_step(calib->jitter_q4, deviation_q4, weight);
+        }
+        if (settled) {
+            uint32_t margin_ticks = IR_PARSER_CALIB_JITTER_MARGIN * calib->jitter_q4 / 16;
+            calib->margin_ticks = ir_max(rmt_parser->margin_ticks / 4, ir_min(margin_ticks, rmt_parser->margin_ticks));
+        }
+    }
+    ir_parser_apply_timing(rmt_parser);
+}
+
+static bool ir_parse_head(ir_rmt_parser_t *rmt_parser)
+{
+    rmt_parser->cursor = 0;
+    rmt_item32_t item = rmt_parser->buffer[rmt_parser->cursor];
+
+    bool level = (item.level0 == rmt_parser->inverse) && (item.level1 != rmt_parser->inverse);
+    if (!level)
+    {
+        IR_REJECT(rmt_parser, head_level, "level : {%u, %u}\n", item.level0, item.level1);
+        return false;
+    }
+    bool margin = ir_check_in_range(item.duration0, rmt_parser->head_mark);
+    if (!margin)
+    {
+        IR_REJECT(rmt_parser, head_mark, "0 : {%u, %u}\n", item.duration0, rmt_parser->ticks.leading_code_high_ticks);
+        return false;
+    }
+    margin &= ir_check_in_range(item.duration1, rmt_parser->head_space);
+    if (!margin)
+    {
+        IR_REJECT(rmt_parser, head_space, "1 : {%u, %u}\n", item.duration1, rmt_parser->ticks.leading_code_low_ticks);
+        return false;
+    }
+    bool ret = level && margin;
+    rmt_parser->cursor += 1;
+    return ret;
+}
+
+// Logic 0 or 1 by a single threshold on the duration that tells them apart, whatever the windows
+static inline int ir_classify_bit(const ir_rmt_parser_t *rmt_parser, uint32_t val)
+{
+    return (((val >> rmt_parser->bit_shift) & 0x7FFF) > rmt_parser->bit_threshold_ticks) ^ rmt_parser->bit_one_below;
+}
+
+// Classify one payload item: returns 0 or 1, or -1 if it is not a valid bit. The threshold picks the logic
+// level, then the mark and space must fit the windows of that level: a duration between the two levels is
+// rejected instead of being taken for the nearer one.
+static inline int ir_parse_bit(const ir_rmt_parser_t *rmt_parser, uint32_t val)
+{
+    uint32_t mark = val & 0x7FFF;
+    uint32_t space = (val >> 16) & 0x7FFF;
+    int bit = ir_classify_bit(rmt_parser, val);
+    if (((val & rmt_parser->level_mask) != rmt_parser->level_expect) ||
+            !ir_check_in_range(mark, rmt_parser->bit_mark[bit]) || !ir_check_in_range(space, rmt_parser->bit_space[bit])) {
+        return -1;
+    }
+    return bit;
+}
+
+// Decode count payload bits (in the order received) in one pass.
+// Returns the index of the first item that is not a valid logic 0/1, or -1 if all bits decoded.
+static inline int ir_parse_bits(const ir_rmt_parser_t *rmt_parser, const rmt_item32_t *items, int count, uint32_t *value)
+{
+    uint32_t bits = 0;
+    for (int i = 0; i < count; i++) {
+        int bit = ir_parse_bit(rmt_parser, items[i].val);
+        if (bit < 0) {
+            return i;
+        }
+        bits |= (uint32_t)bit << i;
+    }
+    *value = bits;
+    return -1;
+}
+
+// Put the bits of a field decoded in the order received into LSB-first order
+static inline uint32_t ir_parse_order(const ir_rmt_parser_t *rmt_parser, uint32_t value, uint32_t bits)
+{
+    if (bits && (rmt_parser->protocol->flags & IR_PROTOCOL_FLAGS_MSB_FIRST)) {
+        return ir_protocol_reverse_bits(value, bits);
+    }
+    return value;
+}
+
+// Decode the address and command bits at items, returns the failing bit index or -1
+static int ir_parse_fields(const ir_rmt_parser_t *rmt_parser, const rmt_item32_t *items, uint32_t *address, uint32_t *command)
+{
+    int fail = ir_parse_bits(rmt_parser, items, rmt_parser->address_bits, address);
+    if (fail >= 0) {
+        return fail;
+    }
+    fail = ir_parse_bits(rmt_parser, items + rmt_parser->address_bits, rmt_parser->command_bits, command);
+    if (fail >= 0) {
+        return rmt_parser->address_bits + fail;
+    }
+    *address = ir_parse_order(rmt_parser, *address, rmt_parser->address_bits);
+    *command = ir_parse_order(rmt_parser, *command, rmt_parser->command_bits);
+    return -1;
+}
+
+// Decode the payload of the input frame, returns the failing bit index or -1
+static int ir_parse_payload(ir_rmt_parser_t *rmt_parser, uint32_t *address, uint32_t *command)
+{
+    int fail = ir_parse_fields(rmt_parser, &rmt_parser->buffer[rmt_parser->cursor], address, command);
+    if (fail < 0) {
+        rmt_parser->cursor += rmt_parser->payload_bits;
+    }
+    return fail;
+}
+
+// Learn from a complete frame that just decoded, or fits the learning windows
+static void ir_calib_learn_frame(ir_rmt_parser_t *rmt_parser, const rmt_item32_t *items)
+{
+    ir_calib_frame_t frame = {0};
+    ir_calib_add(rmt_parser, &frame, IR_CALIB_HEAD_MARK, items[0].duration0, rmt_parser->ticks.leading_code_high_ticks);
+    ir_calib_add(rmt_parser, &frame, IR_CALIB_HEAD_SPACE, items[0].duration1, rmt_parser->ticks.leading_code_low_ticks);
+    // Payload sums kept in locals: this loop runs for every decoded frame
+    int32_t mark_offset_q4 = rmt_parser->source->calib[IR_CALIB_BIT_MARK].offset_q4;
+    int32_t space_offset_q4 = rmt_parser->source->calib[IR_CALIB_BIT_SPACE].offset_q4;
+    int32_t mark_error = 0;
+    int32_t space_error = 0;
+    uint32_t mark_deviation = 0;
+    uint32_t space_deviation = 0;
+    for (uint32_t i = 1; i <= rmt_parser->payload_bits; i++) {
+        // Already checked to fit the windows, only classify it
+        uint32_t bit = ir_classify_bit(rmt_parser, items[i].val);
+        int32_t error = (int32_t)items[i].duration0 - (int32_t)rmt_parser->bit_mark_ticks[bit];
+        mark_error += error;
+        mark_deviation += abs(error * 16 - mark_offset_q4);
+        error = (int32_t)items[i].duration1 - (int32_t)rmt_parser->bit_space_ticks[bit];
+        space_error += error;
+        space_deviation += abs(error * 16 - space_offset_q4);
+    }
+    frame.error[IR_CALIB_BIT_MARK] = mark_error;
+    frame.error[IR_CALIB_BIT_SPACE] = space_error;
+    frame.deviation[IR_CALIB_BIT_MARK] = mark_deviation;
+    frame.deviation[IR_CALIB_BIT_SPACE] = space_deviation;
+    frame.count[IR_CALIB_BIT_MARK] = rmt_parser->payload_bits;
+    frame.count[IR_CALIB_BIT_SPACE] = rmt_parser->payload_bits;
+    ir_calib_add(rmt_parser, &frame, IR_CALIB_ENDING_MARK, items[rmt_parser->payload_bits + 1].duration0,
+                 rmt_parser->ticks.ending_code_high_ticks);
+    ir_calib_learn(rmt_parser, &frame);
+}
+
+static bool ir_parse_ending_frame(ir_rmt_parser_t *rmt_parser)
+{
+    rmt_item32_t item = rmt_parser->buffer[rmt_parser->buffer_length - 1];
+    bool level = (item.level0 == rmt_parser->inverse) && (item.level1 != rmt_parser->inverse);
+    if (!level)
+    {
+        IR_REJECT(rmt_parser, trailer, "level : {%u, %u}\n", item.level0, item.level1);
+        return false;
+    }
+    bool margin = ir_check_in_range(item.duration0, rmt_parser->ending_mark);
+    if (!margin)
+    {
+        IR_REJECT(rmt_parser, trailer, "0 : {%u, %u}\n", item.duration0, rmt_parser->ticks.ending_code_high_ticks);
+        return false;
+    }
+    margin &= (item.duration1 < rmt_parser->margin_ticks);
+    if (!margin)
+    {
+        IR_REJECT(rmt_parser, trailer, "1 : {%u, %u}\n", item.duration1, rmt_parser->ticks.ending_code_low_ticks);
+        return false;
+    }
+    return  level && margin;
+}
+
+static inline bool ir_item_is_head(const ir_rmt_parser_t *rmt_parser, rmt_item32_t item)
+{
+    return ((item.val & rmt_parser->level_mask) == rmt_parser->level_expect) &&
+           ir_check_in_range(item.duration0, rmt_parser->head_mark) &&
+           ir_check_in_range(item.duration1, rmt_parser->head_space);
+}
+
+// The ending space is either cut short by the RMT idle threshold or, when frames arrive merged, the gap to the next one
+static inline bool ir_item_is_ending(const ir_rmt_parser_t *rmt_parser, rmt_item32_t item)
+{
+    return ((item.val & rmt_parser->level_mask) == rmt_parser->level_expect) &&
+           ir_check_in_range(item.duration0, rmt_parser->ending_mark) &&
+           ((item.duration1 < rmt_parser->margin_ticks) ||
+            (item.duration1 >= ir_max(rmt_parser->bit_space[0].hi, rmt_parser->bit_space[1].hi)));
+}
+
+// Calibrating: tell if an item fits the learning windows of a mark and the space after it
+static inline bool ir_item_is_near(const ir_rmt_parser_t *rmt_parser, rmt_item32_t item, ir_calib_kind_t mark,
+                                   ir_calib_kind_t space)
+{
+    return ((item.val & rmt_parser->level_mask) == rmt_parser->level_expect) &&
+           ir_check_in_range(item.duration0, rmt_parser->learn[mark]) &&
+           ir_check_in_range(item.duration1, rmt_parser->learn[space]);
+}
+
+// Calibrating: tell if a payload item fits the learning windows of the logic level it is classified as
+static inline bool ir_item_is_near_bit(const ir_rmt_parser_t *rmt_parser, rmt_item32_t item)
+{
+    int bit = ir_classify_bit(rmt_parser, item.val);
+    return ((item.val & rmt_parser->level_mask) == rmt_parser->level_expect) &&
+           ir_check_in_range(item.duration0, rmt_parser->learn_bit_mark[bit]) &&
+           ir_check_in_range(item.duration1, rmt_parser->learn_bit_space[bit]);
+}
+
+static inline bool ir_item_is_near_ending(const ir_rmt_parser_t *rmt_parser, rmt_item32_t item)
+{
+    return ((item.val & rmt_parser->level_mask) == rmt_parser->level_expect) &&
+           ir_check_in_range(item.duration0, rmt_parser->learn[IR_CALIB_ENDING_MARK]) &&
+           ((item.duration1 < rmt_parser->margin_ticks) ||
+            (item.duration1 >= ir_max(rmt_parser->learn_bit_space[0].hi, rmt_parser->learn_bit_space[1].hi)));
+}
+
+// Decode a complete frame with the current windows
+static inline bool ir_decode_frame(const ir_rmt_parser_t *rmt_parser, const rmt_item32_t *items, uint32_t *address,
+                                   uint32_t *command)
+{
+    return ir_item_is_head(rmt_parser, items[0]) &&
+           ir_item_is_ending(rmt_parser, items[1 + rmt_parser->payload_bits]) &&
+           ir_parse_fields(rmt_parser, &items[1], address, command) < 0;
+}
+
+// Calibrating: tell if a complete frame fits the learning windows, and classify the address it carries
+static bool ir_calib_near_frame(const ir_rmt_parser_t *rmt_parser, const rmt_item32_t *items, uint32_t *address)
+{
+    if (!ir_item_is_near(rmt_parser, items[0], IR_CALIB_HEAD_MARK, IR_CALIB_HEAD_SPACE) ||
+            !ir_item_is_near_ending(rmt_parser, items[1 + rmt_parser->payload_bits])) {
+        return false;
+    }
+    uint32_t bits = 0;
+    for (uint32_t i = 0; i < rmt_parser->payload_bits; i++) {
+        if (!ir_item_is_near_bit(rmt_parser, items[1 + i])) {
+            return false;
+        }
+        if (i < rmt_parser->address_bits) {
+            bits |= (uint32_t)ir_classify_bit(rmt_parser, items[1 + i].val) << i;
+        }
+    }
+    *address = ir_parse_order(rmt_parser, bits, rmt_parser->address_bits);
+    return true;
+}
+
+// Make the windows follow the timing learned from the remote sending this address. A new remote takes
+// over a free source, or the one seen least recently, and continues the calibration of the remote seen
+// last: delays of the receiver itself apply to every remote. A source that learned nothing yet is taken as is.
+static void ir_calib_select(ir_rmt_parser_t *rmt_parser, uint32_t address)
+{
+    ir_calib_source_t *source = rmt_parser->source;
+    rmt_parser->calib_sequence++;
+    if (source->address != address && source->frames) {
+        ir_calib_source_t *oldest = &rmt_parser->sources[0];
+        source = NULL;
+        for (int i = 0; i < IR_PARSER_CALIB_SOURCES; i++) {
+            ir_calib_source_t *candidate = &rmt_parser->sources[i];
+            if (candidate->frames && candidate->address == address) {
+                source = candidate;
+                break;
+            }
+            if (candidate->seen < oldest->seen) {
+                oldest = candidate;
+            }
+        }
+        if (!source) {
+            *oldest = *rmt_parser->source;
+            source = oldest;
+        }
+        rmt_parser->source = source;
+        ir_parser_apply_timing(rmt_parser);
+    }
+    source->address = address;
+    source->seen = rmt_parser->calib_sequence;
+}
+
+// Calibrating: learn from a frame that missed the windows but fits the learning windows, under the source
+// of its address. A frame from another remote is first tried with the timing of that remote; returns true
+// if it decoded that way.
+static bool ir_calib_near_miss(ir_rmt_parser_t *rmt_parser, const rmt_item32_t *items, uint32_t *address,
+                               uint32_t *command)
+{
+    uint32_t source_address = 0;
+    if (!ir_calib_near_frame(rmt_parser, items, &source_address)) {
+        return false;
+    }
+    const ir_calib_source_t *source = rmt_parser->source;
+    ir_calib_select(rmt_parser, source_address);
+    if (rmt_parser->source != source && ir_decode_frame(rmt_parser, items, address, command)) {
+        return true;
+    }
+    ir_calib_learn_frame(rmt_parser, items);
+    return false;
+}
+
+// Remember a decoded scan code and tell if it repeats the previous one within the repeat window
+static bool ir_check_repeat(ir_rmt_parser_t *rmt_parser, uint32_t address, uint32_t command)
+{
+    atomic_fetch_add_explicit(&rmt_parser->stats.frames, 1, memory_order_relaxed);
+    if (!rmt_parser->repeat_window_us) {
+        rmt_parser->last_address = address;
+        rmt_parser->last_command = command;
+        return false;
+    }
+    int64_t now_us = esp_timer_get_time();
+    // Measured from the previous frame, repeat or not, so a held button keeps repeating
+    bool repeat = rmt_parser->last_valid && address == rmt_parser->last_address && command == rmt_parser->last_command &&
+                  now_us - rmt_parser->last_time_us <= rmt_parser->repeat_window_us;
+    rmt_parser->last_address = address;
+    rmt_parser->last_command = command;
+    rmt_parser->last_time_us = now_us;
+    rmt_parser->last_valid = true;
+    if (repeat) {
+        atomic_fetch_add_explicit(&rmt_parser->stats.repeats, 1, memory_order_relaxed);
+    }
+    return repeat;
+}
+
+static void ir_stream_push(ir_rmt_parser_t *rmt_parser)
+{
+    uint32_t address = ir_parse_order(rmt_parser, rmt_parser->stream_address, rmt_parser->address_bits);
+    uint32_t command = ir_parse_order(rmt_parser, rmt_parser->stream_command, rmt_parser->command_bits);
+    bool repeat = ir_check_repeat(rmt_parser, address, command);
+    if (repeat && (rmt_parser->flags & IR_TOOLS_FLAGS_DROP_REPEAT)) {
+        return;
+    }
+    if (rmt_parser->scan_queue_tail - rmt_parser->scan_queue_head >= IR_PARSER_SCAN_QUEUE_DEPTH) {
+        // Reader fell behind, keep the newest state
+        rmt_parser->scan_queue_head++;
+    }
+    ir_scan_code_t *code = &rmt_parser->scan_queue[rmt_parser->scan_queue_tail % IR_PARSER_SCAN_QUEUE_DEPTH];
+    code->address = address;
+    code->command = command;
+    code->repeat = repeat;
+    code->protocol = rmt_parser->protocol;
+    rmt_parser->scan_queue_tail++;
+}
+
+// Run the frame state machine over a chunk of items of any size, queueing every complete frame
+static void ir_stream_input(ir_rmt_parser_t *rmt_parser, const rmt_item32_t *items, uint32_t length)
+{
+    for (uint32_t i = 0; i < length; i++) {
+        rmt_item32_t item = items[i];
+        switch (rmt_parser->stream_state) {
+        case IR_STREAM_PAYLOAD: {
+            int bit = ir_parse_bit(rmt_parser, item.val);
+            if (bit < 0 && (rmt_parser->flags & IR_TOOLS_FLAGS_CALIBRATE) &&
+                    ir_item_is_near_bit(rmt_parser, item)) {
+                // Near miss: the frame is learned from but not decoded
+                if (!rmt_parser->stream_near_miss) {
+                    rmt_parser->fail_bit = rmt_parser->stream_bit;
+                    IR_REJECT(rmt_parser, bit_timing, "bit %u : {%u, %u}\n", rmt_parser->stream_bit, item.duration0, item.duration1);
+                }
+                rmt_parser->stream_near_miss = true;
+                bit = ir_classify_bit(rmt_parser, item.val);
+            }
+            if (bit >= 0) {
+                if (rmt_parser->flags & IR_TOOLS_FLAGS_CALIBRATE) {
+                    ir_calib_add_bit(rmt_parser, &rmt_parser->stream_calib, item, bit);
+                }
+                if (rmt_parser->stream_bit < rmt_parser->address_bits) {
+                    rmt_parser->stream_address |= (uint32_t)bit << rmt_parser->stream_bit;
+                } else {
+                    rmt_parser->stream_command |= (uint32_t)bit << (rmt_parser->stream_bit - rmt_parser->address_bits);
+                }
+                rmt_parser->stream_bit++;
+                if ((rmt_parser->flags & IR_TOOLS_FLAGS_CALIBRATE) && rmt_parser->stream_bit == rmt_parser->address_bits) {
+                    // The rest of the frame is checked against the timing of the remote sending it
+                    ir_calib_select(rmt_parser, ir_parse_order(rmt_parser, rmt_parser->stream_address, rmt_parser->address_bits));
+                }
+                if (rmt_parser->stream_bit == rmt_parser->payload_bits) {
+                    rmt_parser->stream_state = IR_STREAM_ENDING;
+                }
+                continue;
+            }
+            if (!rmt_parser->stream_near_miss) {
+                rmt_parser->fail_bit = rmt_parser->stream_bit;
+                IR_REJECT(rmt_parser, bit_timing, "bit %u : {%u, %u}\n", rmt_parser->stream_bit, item.duration0, item.duration1);
+            }
+            break;
+        }
+        case IR_STREAM_ENDING: {
+            bool ending = ir_item_is_ending(rmt_parser, item);
+            if (!ending && (rmt_parser->flags & IR_TOOLS_FLAGS_CALIBRATE) && ir_item_is_near_ending(rmt_parser, item)) {
+                if (!rmt_parser->stream_near_miss) {
+                    IR_REJECT(rmt_parser, trailer, "end : {%u, %u}\n", item.duration0, item.duration1);
+                }
+                rmt_parser->stream_near_miss = true;
+                ending = true;
+            }
+            if (ending) {
+                if (!rmt_parser->stream_near_miss) {
+                    ir_stream_push(rmt_parser);
+                }
+                if (rmt_parser->flags & IR_TOOLS_FLAGS_CALIBRATE) {
+                    ir_calib_add(rmt_parser, &rmt_parser->stream_calib, IR_CALIB_ENDING_MARK, item.duration0,
+                                 rmt_parser->ticks.ending_code_high_ticks);
+                    ir_calib_learn(rmt_parser, &rmt_parser->stream_calib);
+                }
+                rmt_parser->stream_state = IR_STREAM_WAIT_HEAD;
+                continue;
+            }
+            if (!rmt_parser->stream_near_miss) {
+                IR_REJECT(rmt_parser, trailer, "end : {%u, %u}\n", item.duration0, item.duration1);
+            }
+            break;
+        }
+        case IR_STREAM_WAIT_HEAD:
+            break;
+        }
+        // Waiting for a frame, or the current one broke: resynchronise on this item
+        bool head = ir_item_is_head(rmt_parser, item);
+        bool near_miss = !head && (rmt_parser->flags & IR_TOOLS_FLAGS_CALIBRATE) &&
+                         ir_item_is_near(rmt_parser, item, IR_CALIB_HEAD_MARK, IR_CALIB_HEAD_SPACE);
+        if (head || near_miss) {
+            rmt_parser->stream_state = rmt_parser->payload_bits ? IR_STREAM_PAYLOAD : IR_STREAM_ENDING;
+            rmt_parser->stream_bit = 0;
+            rmt_parser->stream_address = 0;
+            rmt_parser->stream_command = 0;
+            rmt_parser->stream_near_miss = near_miss;
+            if (rmt_parser->flags & IR_TOOLS_FLAGS_CALIBRATE) {
+                memset(&rmt_parser->stream_calib, 0, sizeof(rmt_parser->stream_calib));
+                ir_calib_add(rmt_parser, &rmt_parser->stream_calib, IR_CALIB_HEAD_MARK, item.duration0,
+                             rmt_parser->ticks.leading_code_high_ticks);
+                ir_calib_add(rmt_parser, &rmt_parser->stream_calib, IR_CALIB_HEAD_SPACE, item.duration1,
+                             rmt_parser->ticks.leading_code_low_ticks);
+            }
+        } else {
+            rmt_parser->stream_state = IR_STREAM_WAIT_HEAD;
+        }
+    }
+}
+
+// Count a frame that starts with a leading code but did not decode, by the first check it failed
+static void ir_scan_reject(ir_rmt_parser_t *rmt_parser, const rmt_item32_t *items, uint32_t length)
+{
+    if (length < rmt_parser->frame_items) {
+        IR_REJECT(rmt_parser, length, "length = %u\n", length);
+        return;
+    }
+    uint32_t address = 0;
+    uint32_t command = 0;
+    int fail = ir_parse_fields(rmt_parser, &items[1], &address, &command);
+    if (fail >= 0) {
+        rmt_parser->fail_bit = fail;
+        IR_REJECT(rmt_parser, bit_timing, "bit %d : {%u, %u}\n", fail, items[1 + fail].duration0, items[1 + fail].duration1);
+        return;
+    }
+    IR_REJECT(rmt_parser, trailer, "end : {%u, %u}\n", items[1 + rmt_parser->payload_bits].duration0,
+              items[1 + rmt_parser->payload_bits].duration1);
+}
+
+// Find every complete frame in a buffer without keeping state, decoding each with the single-pass payload decoder.
+// A leading code that starts no decodable frame, or a frame cut short by the end of the buffer, is a rejected frame.
+static uint32_t ir_scan_frames(ir_rmt_parser_t *rmt_parser, const rmt_item32_t *items, uint32_t length,
+                              ir_scan_code_t *codes, uint32_t max_codes)
+{
+    uint32_t num_codes = 0;
+    uint32_t i = 0;
+    while (i + rmt_parser->frame_items <= length && num_codes < max_codes) {
+        uint32_t address = 0;
+        uint32_t command = 0;
+        bool decoded = ir_decode_frame(rmt_parser, &items[i], &address, &command);
+        if (!decoded && (rmt_parser->flags & IR_TOOLS_FLAGS_CALIBRATE)) {
+            decoded = ir_calib_near_miss(rmt_parser, &items[i], &address, &command);
+        }
+        if (decoded) {
+            bool repeat = ir_check_repeat(rmt_parser, address, command);
+            if (!repeat || !(rmt_parser->flags & IR_TOOLS_FLAGS_DROP_REPEAT)) {
+                codes[num_codes].address = address;
+                codes[num_codes].command = command;
+                codes[num_codes].repeat = repeat;
+                codes[num_codes].protocol = rmt_parser->protocol;
+                num_codes++;
+            }
+            if (rmt_parser->flags & IR_TOOLS_FLAGS_CALIBRATE) {
+                ir_calib_select(rmt_parser, address);
+                ir_calib_learn_frame(rmt_parser, &items[i]);
+            }
+            i += rmt_parser->frame_items;
+        } else {
+            if (ir_item_is_head(rmt_parser, items[i])) {
+                ir_scan_reject(rmt_parser, &items[i], length - i);
+            }
+            i++;
+        }
+    }
+    for (; i < length && num_codes < max_codes; i++) {
+        if (ir_item_is_head(rmt_parser, items[i])) {
+            ir_scan_reject(rmt_parser, &items[i], length - i);
+            break;
+        }
+    }
+    return num_codes;
+}
+
+static esp_err_t rmt_parser_decode_batch(ir_parser_t *parser, void *raw_data, uint32_t length,
+                                         ir_scan_code_t *codes, uint32_t max_codes, uint32_t *num_codes)
+{
+    esp_err_t ret = ESP_OK;
+    ir_rmt_parser_t *rmt_parser = __containerof(parser, ir_rmt_parser_t, parent);
+    IR_CHECK(raw_data && codes && num_codes, "raw data, codes and num_codes can't be null", err, ESP_ERR_INVALID_ARG);
+    if (!(rmt_parser->flags & IR_TOOLS_FLAGS_STREAM)) {
+        *num_codes = ir_scan_frames(rmt_parser, raw_data, length, codes, max_codes);
+        return ESP_OK;
+    }
+    ir_stream_input(rmt_parser, raw_data, length);
+    uint32_t count = 0;
+    while (count < max_codes && rmt_parser->scan_queue_head != rmt_parser->scan_queue_tail) {
+        codes[count++] = rmt_parser->scan_queue[rmt_parser->scan_queue_head % IR_PARSER_SCAN_QUEUE_DEPTH];
+        rmt_parser->scan_queue_head++;
+    }
+    *num_codes = count;
+    return ESP_OK;
+err:
+    return ret;
+}
+
+static esp_err_t rmt_parser_input(ir_parser_t *parser, void *raw_data, uint32_t length)
+{
+    esp_err_t ret = ESP_OK;
+    ir_rmt_parser_t *rmt_parser = __containerof(parser, ir_rmt_parser_t, parent);
+    IR_CHECK(raw_data, "input data can't be null", err, ESP_ERR_INVALID_ARG);
+    if (rmt_parser->flags & IR_TOOLS_FLAGS_STREAM) {
+        ir_stream_input(rmt_parser, raw_data, length);
+        return ESP_OK;
+    }
+    // Leading code, one item per payload bit and ending code
+    if (length != rmt_parser->frame_items)
+    {
+        IR_REJECT(rmt_parser, length, "length = %u\n", length);
+        ret = ESP_FAIL;
+        goto err;
+    }
+    rmt_parser->buffer = raw_data;
+    rmt_parser->buffer_length = length;
+    // ESP_LOGI("parser input", "length : %u \t buffersize : %u\n", length, (uint32_t)(sizeof(rmt_parser->buffer)/sizeof(rmt_parser->buffer[0])) );
+    return ret;
+err:
+    return ret;
+}
+
+static esp_err_t rmt_parser_get_scan_code(ir_parser_t *parser, uint32_t *address, uint32_t *command, bool *repeat)
+{
+    esp_err_t ret = ESP_FAIL;
+    uint32_t addr = 0;
+    uint32_t cmd = 0;
+    ir_rmt_parser_t *rmt_parser = __containerof(parser, ir_rmt_parser_t, parent);
+    IR_CHECK(address && command && repeat, "address, command and repeat can't be null", out, ESP_ERR_INVALID_ARG);
+
+    *repeat = false;
+    if (rmt_parser->flags & IR_TOOLS_FLAGS_STREAM) {
+        if (rmt_parser->scan_queue_head != rmt_parser->scan_queue_tail) {
+            ir_scan_code_t *code = &rmt_parser->scan_queue[rmt_parser->scan_queue_head % IR_PARSER_SCAN_QUEUE_DEPTH];
+            *address = code->address;
+            *command = code->command;
+            *repeat = code->repeat;
+            rmt_parser->scan_queue_head++;
+            ret = ESP_OK;
+        }
+        return ret;
+    }
+    rmt_parser->fail_bit = -1;
+    // Calibrating: a frame that fits the learning windows is checked against the timing of the remote
+    // sending it, and learned from whether it decodes or nearly did
+    uint32_t source_address = 0;
+    bool near_frame = (rmt_parser->flags & IR_TOOLS_FLAGS_CALIBRATE) &&
+                      ir_calib_near_frame(rmt_parser, rmt_parser->buffer, &source_address);
+    if (near_frame) {
+        ir_calib_select(rmt_parser, source_address);
+    }
+
+    if (ir_parse_head(rmt_parser) && ir_parse_ending_frame(rmt_parser))
+    {
+        rmt_parser->fail_bit = ir_parse_payload(rmt_parser, &addr, &cmd);
+        if (rmt_parser->fail_bit >= 0)
+        {
+            IR_REJECT(rmt_parser, bit_timing, "bit %d\n", rmt_parser->fail_bit);
+        }
+        else
+        {
+            *repeat = ir_check_repeat(rmt_parser, addr, cmd);
+            if (!*repeat || !(rmt_parser->flags & IR_TOOLS_FLAGS_DROP_REPEAT)) {
+                *address = addr;
+                *command = cmd;
+                ret = ESP_OK;
+            }
+        }
+    }
+    if (near_frame) {
+        ir_calib_learn_frame(rmt_parser, rmt_parser->buffer);
+    }
+    return ret;
+out:
+    return ret;
+}
+
+esp_err_t ir_parser_rmt_get_fail_bit(ir_parser_t *parser, int *bit)
+{
+    esp_err_t ret = ESP_OK;
+    IR_CHECK(parser && bit, "parser and bit can't be null", err, ESP_ERR_INVALID_ARG);
+    ir_rmt_parser_t *rmt_parser = __containerof(parser, ir_rmt_parser_t, parent);
+    *bit = rmt_parser->fail_bit;
+    return ESP_OK;
+err:
+    return ret;
+}
+
+esp_err_t ir_parser_rmt_get_stats(ir_parser_t *parser, ir_parser_stats_t *stats)
+{
+    esp_err_t ret = ESP_OK;
+    IR_CHECK(parser && stats, "parser and stats can't be null", err, ESP_ERR_INVALID_ARG);
+    if (parser->decode_batch != rmt_parser_decode_batch) {
+        return ir_parser_dispatch_get_stats(parser, stats);
+    }
+    ir_rmt_parser_t *rmt_parser = __containerof(parser, ir_rmt_parser_t, parent);
+    stats->frames = atomic_load_explicit(&rmt_parser->stats.frames, memory_order_relaxed);
+    stats->head_level = atomic_load_explicit(&rmt_parser->stats.head_level, memory_order_relaxed);
+    stats->head_mark = atomic_load_explicit(&rmt_parser->stats.head_mark, memory_order_relaxed);
+    stats->head_space = atomic_load_explicit(&rmt_parser->stats.head_space, memory_order_relaxed);
+    stats->bit_timing = atomic_load_explicit(&rmt_parser->stats.bit_timing, memory_order_relaxed);
+    stats->length = atomic_load_explicit(&rmt_parser->stats.length, memory_order_relaxed);
+    stats->trailer = atomic_load_explicit(&rmt_parser->stats.trailer, memory_order_relaxed);
+    stats->repeats = atomic_load_explicit(&rmt_parser->stats.repeats, memory_order_relaxed);
+    return ESP_OK;
+err:
+    return ret;
+}
+
+esp_err_t ir_parser_rmt_dump_stats(ir_parser_t *parser)
+{
+    ir_parser_stats_t stats;
+    esp_err_t ret = ir_parser_rmt_get_stats(parser, &stats);
+    if (ret == ESP_OK) {
+        ESP_LOGI(TAG, "frames %u (repeats %u), rejected: head level %u, head mark %u, head space %u, bit timing %u, length %u, trailer %u",
+                 stats.frames, stats.repeats, stats.head_level, stats.head_mark, stats.head_space, stats.bit_timing, stats.length,
+                 stats.trailer);
+    }
+    return ret;
+}
+
+static inline int32_t ir_q4_ticks_to_us(int32_t value_q4, uint32_t counter_clk_hz)
+{
+    return (int64_t)value_q4 * 1000000 / ((int64_t)counter_clk_hz * 16);
+}
+
+static inline int32_t ir_us_to_q4_ticks(int32_t value_us, uint32_t counter_clk_hz)
+{
+    return (int64_t)value_us * counter_clk_hz * 16 / 1000000;
+}
+
+esp_err_t ir_parser_rmt_get_calibration(ir_parser_t *parser, ir_parser_calibration_t *calibration)
+{
+    esp_err_t ret = ESP_OK;
+    IR_CHECK(parser && calibration, "parser and calibration can't be null", err, ESP_ERR_INVALID_ARG);
+    ir_rmt_parser_t *rmt_parser = __containerof(parser, ir_rmt_parser_t, parent);
+    ir_parser_timing_calibration_t *timings[IR_CALIB_MAX] = {
+        &calibration->head_mark, &calibration->head_space, &calibration->bit_mark, &calibration->bit_space, &calibration->ending_mark,
+    };
+    uint32_t counter_clk_hz = rmt_parser->ticks.counter_clk_hz;
+    for (int kind = 0; kind < IR_CALIB_MAX; kind++) {
+        timings[kind]->offset_us = ir_q4_ticks_to_us(rmt_parser->source->calib[kind].offset_q4, counter_clk_hz);
+        timings[kind]->margin_us = ir_q4_ticks_to_us(rmt_parser->source->calib[kind].margin_ticks * 16, counter_clk_hz);
+    }
+    calibration->frames = rmt_parser->source->frames;
+    calibration->address = rmt_parser->source->address;
+    return ESP_OK;
+err:
+    return ret;
+}
+
+esp_err_t ir_parser_rmt_set_calibration(ir_parser_t *parser, const ir_parser_calibration_t *calibration)
+{
+    esp_err_t ret = ESP_OK;
+    IR_CHECK(parser && calibration, "parser and calibration can't be null", err, ESP_ERR_INVALID_ARG);
+    ir_rmt_parser_t *rmt_parser = __containerof(parser, ir_rmt_parser_t, parent);
+    const ir_parser_timing_calibration_t *timings[IR_CALIB_MAX] = {
+        &calibration->head_mark, &calibration->head_space, &calibration->bit_mark, &calibration->bit_space, &calibration->ending_mark,
+    };
+    uint32_t counter_clk_hz = rmt_parser->ticks.counter_clk_hz;
+    ir_calib_t calib[IR_CALIB_MAX];
+    for (int kind = 0; kind < IR_CALIB_MAX; kind++) {
+        int32_t limit_q4 = ir_calib_nominal(rmt_parser, kind) * 8;
+        calib[kind].offset_q4 = ir_us_to_q4_ticks(timings[kind]->offset_us, counter_clk_hz);
+        calib[kind].margin_ticks = timings[kind]->margin_us ?
+                                   (uint32_t)ir_us_to_q4_ticks(timings[kind]->margin_us, counter_clk_hz) / 16 :
+                                   rmt_parser->margin_ticks;
+        calib[kind].jitter_q4 = calib[kind].margin_ticks * 16 / IR_PARSER_CALIB_JITTER_MARGIN;
+        IR_CHECK(calib[kind].offset_q4 <= limit_q4 && calib[kind].offset_q4 >= -limit_q4, "offset %d us out of range", err,
+                 ESP_ERR_INVALID_ARG, timings[kind]->offset_us);
+        IR_CHECK(calib[kind].margin_ticks <= rmt_parser->margin_ticks, "margin %u us above the configured margin", err,
+                 ESP_ERR_INVALID_ARG, timings[kind]->margin_us);
+    }
+    ir_calib_select(rmt_parser, calibration->address);
+    memcpy(rmt_parser->source->calib, calib, sizeof(calib));
+    rmt_parser->source->frames = calibration->frames;
+    ir_parser_apply_timing(rmt_parser);
+    return ESP_OK;
+err:
+    return ret;
+}
+
+static esp_err_t rmt_parser_del(ir_parser_t *parser)
+{
+    ir_rmt_parser_t *rmt_parser = __containerof(parser, ir_rmt_parser_t, parent);
+    free(rmt_parser);
+    return ESP_OK;
+}
+
+// Storage belongs to the caller of ir_parser_rmt_new_static
+static esp_err_t rmt_parser_del_static(ir_parser_t *parser)
+{
+    (void)parser; // storage belongs to the caller
+    return ESP_OK;
+}
+
+// Set up zeroed parser storage, everything but del
+static esp_err_t rmt_parser_init(ir_rmt_parser_t *rmt_parser, const ir_parser_config_t *config, const ir_protocol_t *protocol)
+{
+    esp_err_t ret = ESP_OK;
+    IR_CHECK(protocol->address_bits <= 32 && protocol->command_bits <= 32, "%s payload fields wider than 32 bits", err,
+             ESP_ERR_INVALID_ARG, protocol->name);
+
+    rmt_parser->protocol = protocol;
+    rmt_parser->address_bits = protocol->address_bits;
+    rmt_parser->command_bits = protocol->command_bits;
+    rmt_parser->payload_bits = protocol->address_bits + protocol->command_bits;
+    rmt_parser->frame_items = IR_PROTOCOL_FRAME_ITEMS(protocol);
+    rmt_parser->flags = config->flags;
+    if (config->flags & IR_TOOLS_FLAGS_INVERSE) {
+        rmt_parser->inverse = true;
+    }
+
+    uint32_t counter_clk_hz = 0;
+    IR_CHECK(rmt_get_counter_clock((rmt_channel_t)config->dev_hdl, &counter_clk_hz) == ESP_OK,
+             "get rmt counter clock failed", err, ESP_FAIL);
+    IR_CHECK(ir_protocol_get_ticks(protocol, counter_clk_hz, &rmt_parser->ticks) == ESP_OK,
+             "unsupported rmt counter clock", err, ESP_ERR_NOT_SUPPORTED);
+    rmt_parser->margin_ticks = IR_US_TO_TICKS(config->margin_us, counter_clk_hz);
+    rmt_parser->repeat_window_us = (int64_t)config->repeat_window_ms * 1000;
+    rmt_parser->fail_bit = -1;
+    rmt_item32_t level_mask = {.level0 = 1, .level1 = 1};
+    rmt_item32_t level_expect = {.level0 = rmt_parser->inverse, .level1 = !rmt_parser->inverse};
+    rmt_parser->level_mask = level_mask.val;
+    rmt_parser->level_expect = level_expect.val;
+    const ir_timing_ticks_t *ticks = &rmt_parser->ticks;
+    uint32_t mark0 = ticks->payload_logic0_high_ticks;
+    uint32_t mark1 = ticks->payload_logic1_high_ticks;
+    uint32_t space0 = ticks->payload_logic0_low_ticks;
+    uint32_t space1 = ticks->payload_logic1_low_ticks;
+    rmt_parser->bit_mark_ticks[0] = mark0;
+    rmt_parser->bit_mark_ticks[1] = mark1;
+    rmt_parser->bit_space_ticks[0] = space0;
+    rmt_parser->bit_space_ticks[1] = space1;
+    // Pulse distance protocols tell the bits apart by their space, pulse width ones by their mark
+    if (ir_max(space0, space1) - ir_min(space0, space1) >= ir_max(mark0, mark1) - ir_min(mark0, mark1)) {
+        rmt_parser->bit_shift = 16;
+        rmt_parser->bit_one_below = space1 < space0;
+    } else {
+        rmt_parser->bit_shift = 0;
+        rmt_parser->bit_one_below = mark1 < mark0;
+    }
+    rmt_parser->source = &rmt_parser->sources[0];
+    for (int kind = 0; kind < IR_CALIB_MAX; kind++) {
+        rmt_parser->source->calib[kind].margin_ticks = rmt_parser->margin_ticks;
+    }
+    ir_parser_apply_timing(rmt_parser);
+    rmt_parser->parent.input = rmt_parser_input;
+    rmt_parser->parent.get_scan_code = rmt_parser_get_scan_code;
+    rmt_parser->parent.decode_batch = rmt_parser_decode_batch;
+    return ESP_OK;
+err:
+    return ret;
+}
+
+ir_parser_t *ir_parser_rmt_new(const ir_parser_config_t *config, const ir_protocol_t *protocol)
+{
+    ir_parser_t *ret = NULL;
+    IR_CHECK(config && protocol, "configuration and protocol can't be null", err, NULL);
+    ir_rmt_parser_t *rmt_parser = calloc(1, sizeof(ir_rmt_parser_t));
+    IR_CHECK(rmt_parser, "request memory for rmt_parser failed", err, NULL);
+    if (rmt_parser_init(rmt_parser, config, protocol) != ESP_OK) {
+        free(rmt_parser);
+        return NULL;
+    }
+    rmt_parser->parent.del = rmt_parser_del;
+    return &rmt_parser->parent;
+err:
+    return ret;
+}
+
+ir_parser_t *ir_parser_rmt_new_static(const ir_parser_config_t *config, const ir_protocol_t *protocol, void *storage,
+                                      size_t storage_size)
+{
+    ir_parser_t *ret = NULL;
+    IR_CHECK(config && protocol && storage, "configuration, protocol and storage can't be null", err, NULL);
+    IR_CHECK(storage_size >= sizeof(ir_rmt_parser_t), "storage of %u bytes can't hold %u", err, NULL, (unsigned)storage_size,
+             (unsigned)sizeof(ir_rmt_parser_t));
+    IR_CHECK(!((uintptr_t)storage % _Alignof(ir_rmt_parser_t)), "storage not aligned", err, NULL);
+    memset(storage, 0, sizeof(ir_rmt_parser_t));
+    ir_rmt_parser_t *rmt_parser = (ir_rmt_parser_t *)storage;
+    if (rmt_parser_init(rmt_parser, config, protocol) != ESP_OK) {
+        return NULL;
+    }
+    rmt_parser->parent.del = rmt_parser_del_static;
+    return &rmt_parser->parent;
+err:
+    return ret;
+}
+
+ir_parser_t *ir_parser_rmt_new_samsung(const ir_parser_config_t *config)
+{
+    return ir_parser_rmt_new(config, &ir_protocol_samsung);
+}
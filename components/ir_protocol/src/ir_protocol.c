@@ -0,0 +1,75 @@
+// Copyright 2019 Espressif Systems (Shanghai) PTE LTD
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include <stddef.h>
+#include "ir_protocol.h"
+
+// 80 MHz APB clock with clk_div 160, 80 (RMT_DEFAULT_CONFIG_*), 40 and 20
+static const ir_timing_ticks_t s_samsung_ticks[] = {
+    IR_TIMING_TICKS(SAMSUNG, 500000),
+    IR_TIMING_TICKS(SAMSUNG, 1000000),
+    IR_TIMING_TICKS(SAMSUNG, 2000000),
+    IR_TIMING_TICKS(SAMSUNG, 4000000),
+};
+
+static const ir_timing_ticks_t s_nec_ticks[] = {
+    IR_TIMING_TICKS(NEC, 500000),
+    IR_TIMING_TICKS(NEC, 1000000),
+    IR_TIMING_TICKS(NEC, 2000000),
+    IR_TIMING_TICKS(NEC, 4000000),
+};
+
+const ir_protocol_t ir_protocol_samsung = {
+    .name = "samsung",
+    IR_PROTOCOL_TIMINGS(SAMSUNG),
+    .address_bits = 16,
+    .command_bits = 32,
+    .flags = IR_PROTOCOL_FLAGS_INVERSE_PAIRS,
+    .repeat_period_ms = 5,
+    .ticks = s_samsung_ticks,
+    .num_ticks = sizeof(s_samsung_ticks) / sizeof(s_samsung_ticks[0]),
+};
+
+const ir_protocol_t ir_protocol_nec = {
+    .name = "nec",
+    IR_PROTOCOL_TIMINGS(NEC),
+    .address_bits = 16,
+    .command_bits = 16,
+    .flags = IR_PROTOCOL_FLAGS_INVERSE_PAIRS,
+    .repeat_period_ms = 110,
+    .ticks = s_nec_ticks,
+    .num_ticks = sizeof(s_nec_ticks) / sizeof(s_nec_ticks[0]),
+};
+
+esp_err_t ir_protocol_get_ticks(const ir_protocol_t *protocol, uint32_t counter_clk_hz, ir_timing_ticks_t *ticks)
+{
+    if (!protocol || !counter_clk_hz || !ticks) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    for (size_t i = 0; i < protocol->num_ticks; i++) {
+        if (protocol->ticks[i].counter_clk_hz == counter_clk_hz) {
+            *ticks = protocol->ticks[i];
+            return ESP_OK;
+        }
+    }
+    ticks->counter_clk_hz = counter_clk_hz;
+    ticks->leading_code_high_ticks = IR_US_TO_TICKS(protocol->leading_code_high_us, counter_clk_hz);
+    ticks->leading_code_low_ticks = IR_US_TO_TICKS(protocol->leading_code_low_us, counter_clk_hz);
+    ticks->payload_logic0_high_ticks = IR_US_TO_TICKS(protocol->payload_zero_high_us, counter_clk_hz);
+    ticks->payload_logic0_low_ticks = IR_US_TO_TICKS(protocol->payload_zero_low_us, counter_clk_hz);
+    ticks->payload_logic1_high_ticks = IR_US_TO_TICKS(protocol->payload_one_high_us, counter_clk_hz);
+    ticks->payload_logic1_low_ticks = IR_US_TO_TICKS(protocol->payload_one_low_us, counter_clk_hz);
+    ticks->ending_code_high_ticks = IR_US_TO_TICKS(protocol->ending_code_high_us, counter_clk_hz);
+    ticks->ending_code_low_ticks = IR_US_TO_TICKS(protocol->ending_code_low_us, counter_clk_hz);
+    return ESP_OK;
+}
@@ -0,0 +1,99 @@
+// Copyright 2019 Espressif Systems (Shanghai) PTE LTD
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include "esp_timer.h"
+#include "ir_trace.h"
+
+static const char *const s_event_names[IR_TRACE_EVENT_MAX] = {
+    [IR_TRACE_TX_START] = "tx_start",
+    [IR_TRACE_TX_END] = "tx_end",
+    [IR_TRACE_RX_DELIVER] = "rx_deliver",
+    [IR_TRACE_DECODE_OK] = "decode_ok",
+    [IR_TRACE_DECODE_FAIL] = "decode_fail",
+    [IR_TRACE_REPEAT_DROP] = "repeat_drop",
+};
+
+esp_err_t ir_trace_init(ir_trace_t *trace, ir_trace_slot_t *slots, uint32_t num_slots)
+{
+    if (!trace || !slots || !num_slots || (num_slots & (num_slots - 1))) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    for (uint32_t i = 0; i < num_slots; i++) {
+        slots[i].seq = i;
+    }
+    trace->slots = slots;
+    trace->mask = num_slots - 1;
+    trace->head = 0;
+    trace->tail = 0;
+    trace->dropped = 0;
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    return ESP_OK;
+}
+
+void ir_trace_record(ir_trace_t *trace, ir_trace_event_t event, uint32_t channel, uint32_t payload)
+{
+    if (!trace) {
+        return;
+    }
+    uint32_t timestamp_us = (uint32_t)esp_timer_get_time();
+    uint32_t pos = __atomic_load_n(&trace->head, __ATOMIC_RELAXED);
+    ir_trace_slot_t *slot;
+    while (1) {
+        slot = &trace->slots[pos & trace->mask];
+        int32_t diff = (int32_t)(__atomic_load_n(&slot->seq, __ATOMIC_ACQUIRE) - pos);
+        if (!diff) {
+            // Slot free at pos: claim it, or retry at the position another writer left
+            if (__atomic_compare_exchange_n(&trace->head, &pos, pos + 1, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+                break;
+            }
+        } else if (diff < 0) {
+            // Not yet read since the last lap: full
+            __atomic_fetch_add(&trace->dropped, 1, __ATOMIC_RELAXED);
+            return;
+        } else {
+            pos = __atomic_load_n(&trace->head, __ATOMIC_RELAXED);
+        }
+    }
+    slot->record.timestamp_us = timestamp_us;
+    slot->record.event = event;
+    slot->record.channel = channel;
+    slot->record.payload = payload;
+    __atomic_store_n(&slot->seq, pos + 1, __ATOMIC_RELEASE);
+}
+
+esp_err_t ir_trace_read(ir_trace_t *trace, ir_trace_record_t *record)
+{
+    if (!trace || !record) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    uint32_t pos = trace->tail;
+    ir_trace_slot_t *slot = &trace->slots[pos & trace->mask];
+    if (__atomic_load_n(&slot->seq, __ATOMIC_ACQUIRE) != pos + 1) {
+        return ESP_ERR_NOT_FOUND;
+    }
+    *record = slot->record;
+    // Free the slot for the writer a lap later
+    __atomic_store_n(&slot->seq, pos + trace->mask + 1, __ATOMIC_RELEASE);
+    trace->tail = pos + 1;
+    return ESP_OK;
+}
+
+uint32_t ir_trace_get_dropped(const ir_trace_t *trace)
+{
+    return trace ? __atomic_load_n(&trace->dropped, __ATOMIC_RELAXED) : 0;
+}
+
+const char *ir_trace_event_name(ir_trace_event_t event)
+{
+    return (unsigned)event < IR_TRACE_EVENT_MAX ? s_event_names[event] : "unknown";
+}
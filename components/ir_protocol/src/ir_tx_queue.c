@@ -0,0 +1,178 @@
+// Copyright 2019 Espressif Systems (Shanghai) PTE LTD
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include <string.h>
+#include "ir_tx_queue.h"
+
+void ir_tx_queue_init(ir_tx_queue_t *queue)
+{
+    memset(queue, 0, sizeof(*queue));
+}
+
+esp_err_t ir_tx_queue_push(ir_tx_queue_t *queue, const ir_tx_command_t *command, bool *coalesced)
+{
+    if (!queue || !command) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    for (uint32_t i = 0; i < queue->count; i++) {
+        ir_tx_command_t *pending = &queue->commands[i];
+        if (pending->unit == command->unit) {
+            // Newer state of the same unit: the pending one is obsolete
+            pending->address = command->address;
+            pending->command = command->command;
+            pending->channels = command->channels;
+            pending->priority = command->priority > pending->priority ? command->priority : pending->priority;
+            queue->coalesced++;
+            if (coalesced) {
+                *coalesced = true;
+            }
+            return ESP_OK;
+        }
+    }
+    if (queue->count == IR_TX_QUEUE_DEPTH) {
+        return ESP_ERR_NO_MEM;
+    }
+    queue->commands[queue->count] = *command;
+    queue->order[queue->count] = queue->sequence++;
+    queue->count++;
+    if (coalesced) {
+        *coalesced = false;
+    }
+    return ESP_OK;
+}
+
+static ir_tx_command_t *ir_tx_queue_find_sent(ir_tx_queue_t *queue, uint32_t unit)
+{
+    for (uint32_t i = 0; i < queue->sent_count; i++) {
+        if (queue->sent[i].unit == unit) {
+            return &queue->sent[i];
+        }
+    }
+    return NULL;
+}
+
+static void ir_tx_queue_remove(ir_tx_queue_t *queue, uint32_t index)
+{
+    queue->count--;
+    queue->commands[index] = queue->commands[queue->count];
+    queue->order[index] = queue->order[queue->count];
+}
+
+esp_err_t ir_tx_queue_push_changed(ir_tx_queue_t *queue, const ir_tx_command_t *command, bool *skipped)
+{
+    if (!queue || !command) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    const ir_tx_command_t *sent = ir_tx_queue_find_sent(queue, command->unit);
+    if (!sent || sent->address != command->address || sent->command != command->command) {
+        if (skipped) {
+            *skipped = false;
+        }
+        return ir_tx_queue_push(queue, command, NULL);
+    }
+    for (uint32_t i = 0; i < queue->count; i++) {
+        if (queue->commands[i].unit == command->unit) {
+            ir_tx_queue_remove(queue, i);
+            break;
+        }
+    }
+    queue->skipped++;
+    if (skipped) {
+        *skipped = true;
+    }
+    return ESP_OK;
+}
+
+void ir_tx_queue_mark_sent(ir_tx_queue_t *queue, const ir_tx_command_t *command)
+{
+    ir_tx_command_t *sent = ir_tx_queue_find_sent(queue, command->unit);
+    if (!sent) {
+        if (queue->sent_count < IR_TX_QUEUE_UNITS) {
+            sent = &queue->sent[queue->sent_count++];
+        } else {
+            sent = &queue->sent[queue->sent_next];
+            queue->sent_next = (queue->sent_next + 1) % IR_TX_QUEUE_UNITS;
+        }
+    }
+    *sent = *command;
+}
+
+esp_err_t ir_tx_queue_pop(ir_tx_queue_t *queue, ir_tx_command_t *command)
+{
+    return ir_tx_queue_pop_ready(queue, UINT32_MAX, command);
+}
+
+// Index of the command to send next among those whose channels are all free, -1 if none
+static int ir_tx_queue_select(const ir_tx_queue_t *queue, uint32_t free_channels)
+{
+    int next = -1;
+    for (uint32_t i = 0; i < queue->count; i++) {
+        const ir_tx_command_t *candidate = &queue->commands[i];
+        if (candidate->channels & ~free_channels) {
+            continue;
+        }
+        // Sequence numbers compared by difference so wrap-around keeps the order
+        if (next < 0 || candidate->priority > queue->commands[next].priority ||
+                (candidate->priority == queue->commands[next].priority && (int32_t)(queue->order[i] - queue->order[next]) < 0)) {
+            next = i;
+        }
+    }
+    return next;
+}
+
+esp_err_t ir_tx_queue_pop_ready(ir_tx_queue_t *queue, uint32_t free_channels, ir_tx_command_t *command)
+{
+    if (!queue || !command) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    int next = ir_tx_queue_select(queue, free_channels);
+    if (next < 0) {
+        return ESP_ERR_NOT_FOUND;
+    }
+    *command = queue->commands[next];
+    ir_tx_queue_remove(queue, next);
+    return ESP_OK;
+}
+
+esp_err_t ir_tx_queue_peek_ready(const ir_tx_queue_t *queue, uint32_t free_channels, ir_tx_command_t *command)
+{
+    if (!queue || !command) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    int next = ir_tx_queue_select(queue, free_channels);
+    if (next < 0) {
+        return ESP_ERR_NOT_FOUND;
+    }
+    *command = queue->commands[next];
+    return ESP_OK;
+}
+
+esp_err_t ir_tx_queue_commit(ir_tx_queue_t *queue, const ir_tx_command_t *command)
+{
+    if (!queue || !command) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    for (uint32_t i = 0; i < queue->count; i++) {
+        const ir_tx_command_t *pending = &queue->commands[i];
+        if (pending->unit == command->unit) {
+            // Replaced by a newer state since it was peeked: that one is still to be sent
+            if (pending->address != command->address || pending->command != command->command ||
+                    pending->channels != command->channels) {
+                return ESP_ERR_NOT_FOUND;
+            }
+            ir_tx_queue_remove(queue, i);
+            return ESP_OK;
+        }
+    }
+    return ESP_ERR_NOT_FOUND;
+}
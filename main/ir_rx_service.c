@@ -0,0 +1,265 @@
+#include <stdlib.h>
+#include <string.h>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+#include "freertos/ringbuf.h"
+
+#include "esp_log.h"
+#include "esp_attr.h"
+#include "esp_timer.h"
+#include "driver/gpio.h"
+
+#include "ir_rx_service.h"
+#include "ir_filter.h"
+
+static const char *TAG = "ir_rx_service";
+
+#define IR_RX_SERVICE_MAX_CODES (8) // scan codes decoded from one ring buffer item
+
+// The edge interrupt may run on another core than the task: the time is taken from esp_timer, common
+// to both cores, instead of the cycle counter of each core
+static void IRAM_ATTR ir_rx_service_edge_isr(void *arg)
+{
+    ((ir_rx_channel_t *)arg)->last_edge_us = (uint32_t)esp_timer_get_time();
+}
+
+// Frames a parser rejected so far, whatever check they failed
+static inline uint32_t ir_rx_service_rejected(const ir_parser_stats_t *stats)
+{
+    return stats->head_level + stats->head_mark + stats->head_space + stats->bit_timing + stats->length + stats->trailer;
+}
+
+// Trace what the parser did with a burst beyond the codes it returned: frames it rejected and repeats it
+// dropped. A chunk holding part of a frame adds to neither.
+static void ir_rx_service_trace_stats(ir_rx_service_t *service, uint32_t index, const ir_scan_code_t *codes,
+                                      uint32_t num_codes)
+{
+    ir_rx_channel_t *rx = &service->channels[index];
+    ir_parser_stats_t stats;
+    if (!service->trace || ir_parser_rmt_get_stats(rx->parser, &stats) != ESP_OK) {
+        return;
+    }
+    uint32_t rejected = ir_rx_service_rejected(&stats) - rx->rejected;
+    uint32_t repeats = stats.repeats - rx->repeats;
+    uint32_t returned = 0;
+    rx->rejected += rejected;
+    rx->repeats += repeats;
+    for (uint32_t i = 0; i < num_codes; i++) {
+        returned += codes[i].repeat;
+    }
+    uint32_t dropped = repeats > returned ? repeats - returned : 0;
+    if (rejected) {
+        ir_trace_record(service->trace, IR_TRACE_DECODE_FAIL, index, rejected);
+    }
+    if (dropped) {
+        ir_trace_record(service->trace, IR_TRACE_REPEAT_DROP, index, dropped);
+    }
+}
+
+static void ir_rx_service_decode(ir_rx_service_t *service, uint32_t index, rmt_item32_t *items, size_t length)
+{
+    ir_rx_channel_t *rx = &service->channels[index];
+    ir_scan_code_t codes[IR_RX_SERVICE_MAX_CODES];
+    uint32_t num_codes = 0;
+    uint32_t received = ir_latency_now();
+    uint32_t start = received;
+    if (rx->edge_gpio >= 0) {
+        // The burst ended idle_us after its last edge, unless a newer burst has started since
+        uint32_t since_edge_us = (uint32_t)esp_timer_get_time() - rx->last_edge_us;
+        if (since_edge_us >= rx->idle_us) {
+            uint32_t deliver = (since_edge_us - rx->idle_us) * service->latency[IR_RX_LATENCY_DELIVER].cycles_per_us;
+            start = received - deliver;
+            ir_latency_add(&service->latency[IR_RX_LATENCY_DELIVER], deliver);
+        }
+    }
+    ir_trace_record(service->trace, IR_TRACE_RX_DELIVER, index, length);
+    if (service->on_items) {
+        service->on_items(index, items, length, service->arg);
+    }
+    ir_filter_glitches(items, &length, rx->glitch_ticks, NULL);
+    if (length < 2) {
+        // Noise only: even the shortest frame has a head and an ending
+        return;
+    }
+    uint32_t input = ir_latency_now();
+    ir_latency_add(&service->latency[IR_RX_LATENCY_INPUT], input - received);
+    // Decode every frame of a burst at once
+    esp_err_t ret = rx->parser->decode_batch(rx->parser, items, length, codes, IR_RX_SERVICE_MAX_CODES, &num_codes);
+    ir_latency_since(&service->latency[IR_RX_LATENCY_DECODE], input);
+    if (ret != ESP_OK) {
+        num_codes = 0;
+    }
+    ir_rx_service_trace_stats(service, index, codes, num_codes);
+    if (!num_codes) {
+        return;
+    }
+    for (uint32_t i = 0; i < num_codes; i++) {
+        ir_trace_record(service->trace, IR_TRACE_DECODE_OK, index, codes[i].command);
+        service->on_code(index, &codes[i], service->arg);
+    }
+    ir_latency_since(&service->latency[IR_RX_LATENCY_TOTAL], start);
+}
+
+static void ir_rx_service_task(void *arg)
+{
+    ir_rx_service_t *service = (ir_rx_service_t *)arg;
+    while (1) {
+        QueueSetMemberHandle_t member = xQueueSelectFromSet(service->ringbufs, portMAX_DELAY);
+        for (uint32_t i = 0; i < service->num_channels; i++) {
+            ir_rx_channel_t *rx = &service->channels[i];
+            if (!xRingbufferCanRead(rx->ringbuf, member)) {
+                continue;
+            }
+            size_t length = 0;
+            rmt_item32_t *items = (rmt_item32_t *)xRingbufferReceive(rx->ringbuf, &length, 0);
+            if (items) {
+                ir_rx_service_decode(service, i, items, length / sizeof(rmt_item32_t));
+                //after parsing the data, return spaces to ringbuffer.
+                vRingbufferReturnItem(rx->ringbuf, (void *)items);
+            }
+            break;
+        }
+    }
+}
+
+static esp_err_t ir_rx_service_init(ir_rx_service_t *service, const ir_rx_service_config_t *config)
+{
+    if (!config->on_code || !config->num_channels || config->num_channels > IR_RX_SERVICE_MAX_CHANNELS) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    for (uint32_t i = 0; i < config->num_channels; i++) {
+        ir_rx_channel_t *rx = &service->channels[i];
+        uint32_t counter_clk_hz = 0;
+        rx->channel = config->channels[i].channel;
+        rx->parser = config->channels[i].parser;
+        if (!rx->parser || rmt_get_ringbuf_handle(rx->channel, &rx->ringbuf) != ESP_OK || !rx->ringbuf ||
+                rmt_get_counter_clock(rx->channel, &counter_clk_hz) != ESP_OK) {
+            return ESP_ERR_INVALID_ARG;
+        }
+        rx->glitch_ticks = (uint32_t)((uint64_t)config->glitch_us * counter_clk_hz / 1000000);
+        rx->edge_gpio = config->channels[i].edge_gpio;
+        ir_parser_stats_t stats;
+        if (ir_parser_rmt_get_stats(rx->parser, &stats) == ESP_OK) {
+            rx->rejected = ir_rx_service_rejected(&stats);
+            rx->repeats = stats.repeats;
+        }
+    }
+    for (uint32_t i = 0; i < IR_RX_LATENCY_MAX; i++) {
+        ir_latency_init(&service->latency[i]);
+    }
+    service->num_channels = config->num_channels;
+    service->on_code = config->on_code;
+    service->on_items = config->on_items;
+    service->arg = config->arg;
+    service->trace = config->trace;
+    return ESP_OK;
+}
+
+// Once the task waits on the queue set: edge timestamps and reception on every channel
+static void ir_rx_service_start(ir_rx_service_t *service, const ir_rx_service_config_t *config)
+{
+    for (uint32_t i = 0; i < service->num_channels; i++) {
+        ir_rx_channel_t *rx = &service->channels[i];
+        if (rx->edge_gpio >= 0) {
+            uint16_t idle_ticks = 0;
+            uint32_t counter_clk_hz = 0;
+            rmt_get_rx_idle_thresh(rx->channel, &idle_ticks);
+            rmt_get_counter_clock(rx->channel, &counter_clk_hz);
+            rx->idle_us = (uint32_t)((uint64_t)idle_ticks * 1000000 / counter_clk_hz);
+            gpio_set_intr_type(rx->edge_gpio, GPIO_INTR_ANYEDGE);
+            if (gpio_isr_handler_add(rx->edge_gpio, ir_rx_service_edge_isr, rx) != ESP_OK) {
+                ESP_LOGW(TAG, "no edge timestamps on GPIO %d, is the GPIO ISR service installed?", rx->edge_gpio);
+                rx->edge_gpio = -1;
+            }
+        }
+        rmt_rx_start(rx->channel, true);
+    }
+    ESP_LOGI(TAG, "%u receivers, decoding on core %d", service->num_channels, config->task_core);
+}
+
+esp_err_t ir_rx_service_new(const ir_rx_service_config_t *config, ir_rx_service_t **ret_service)
+{
+    if (!config || !ret_service) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    ir_rx_service_t *service = calloc(1, sizeof(ir_rx_service_t));
+    if (!service) {
+        return ESP_ERR_NO_MEM;
+    }
+    esp_err_t ret = ir_rx_service_init(service, config);
+    if (ret != ESP_OK) {
+        goto err;
+    }
+    // A ring buffer takes one slot of the set whatever the number of items it holds
+    service->ringbufs = xQueueCreateSet(config->num_channels);
+    if (!service->ringbufs) {
+        ret = ESP_ERR_NO_MEM;
+        goto err;
+    }
+    for (uint32_t i = 0; i < service->num_channels; i++) {
+        xRingbufferAddToQueueSetRead(service->channels[i].ringbuf, service->ringbufs);
+    }
+    if (xTaskCreatePinnedToCore(ir_rx_service_task, "ir_rx_service", config->task_stack_size, service,
+                                config->task_priority, &service->task, config->task_core) != pdPASS) {
+        ret = ESP_ERR_NO_MEM;
+        goto err;
+    }
+    ir_rx_service_start(service, config);
+    *ret_service = service;
+    return ESP_OK;
+err:
+    if (service->ringbufs) {
+        for (uint32_t i = 0; i < service->num_channels; i++) {
+            xRingbufferRemoveFromQueueSetRead(service->channels[i].ringbuf, service->ringbufs);
+        }
+        vQueueDelete(service->ringbufs);
+    }
+    free(service);
+    return ret;
+}
+
+esp_err_t ir_rx_service_new_static(const ir_rx_service_config_t *config, StackType_t *task_stack,
+                                   ir_rx_service_static_t *storage, ir_rx_service_t **ret_service)
+{
+    if (!config || !task_stack || !storage || !ret_service) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    ir_rx_service_t *service = &storage->service;
+    memset(storage, 0, sizeof(*storage));
+    esp_err_t ret = ir_rx_service_init(service, config);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    // No static variant of xQueueCreateSet in this FreeRTOS: a queue set is a queue of member handles,
+    // created here the way xQueueCreateSet does. None of these can fail with the buffers given.
+    service->ringbufs = xQueueGenericCreateStatic(config->num_channels, sizeof(QueueSetMemberHandle_t),
+                                                  storage->ringbufs_items, &storage->ringbufs, queueQUEUE_TYPE_SET);
+    for (uint32_t i = 0; i < service->num_channels; i++) {
+        xRingbufferAddToQueueSetRead(service->channels[i].ringbuf, service->ringbufs);
+    }
+    service->task = xTaskCreateStaticPinnedToCore(ir_rx_service_task, "ir_rx_service", config->task_stack_size, service,
+                                                  config->task_priority, task_stack, &storage->task, config->task_core);
+    ir_rx_service_start(service, config);
+    *ret_service = service;
+    return ESP_OK;
+}
+
+esp_err_t ir_rx_service_get_latency(ir_rx_service_t *service, ir_rx_latency_stage_t stage, ir_latency_hist_t *hist)
+{
+    if (!service || stage >= IR_RX_LATENCY_MAX || !hist) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    *hist = service->latency[stage];
+    return ESP_OK;
+}
+
+esp_err_t ir_rx_service_get_task(ir_rx_service_t *service, TaskHandle_t *task)
+{
+    if (!service || !task) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    *task = service->task;
+    return ESP_OK;
+}
@@ -0,0 +1,175 @@
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_err.h"
+#include "driver/rmt.h"
+#include "ir_tools.h"
+#include "ir_latency.h"
+#include "ir_trace.h"
+
+#define IR_RX_SERVICE_MAX_CHANNELS (4) /*!< RMT RX channels one service drives */
+
+/**
+ * @brief Stages of reception timed by the RX service
+ *
+ */
+typedef enum {
+    IR_RX_LATENCY_DELIVER, /*!< End of the burst, the idle threshold after its last edge, to its items received by the task.
+                                Needs edge_gpio, empty otherwise */
+    IR_RX_LATENCY_INPUT,   /*!< Items received to parser input: raw items handler and glitch filter */
+    IR_RX_LATENCY_DECODE,  /*!< Parser input to scan codes out */
+    IR_RX_LATENCY_TOTAL,   /*!< End of the burst, or items received without edge_gpio, to the last scan code reported */
+    IR_RX_LATENCY_MAX,
+} ir_rx_latency_stage_t;
+
+/**
+ * @brief RX service: one decode task serving the ring buffers of several RMT channels
+ *
+ */
+typedef struct ir_rx_service_s ir_rx_service_t;
+
+/**
+ * @brief Called from the service task for every scan code decoded
+ *
+ * @param[in] index: Index of the receiver in the service configuration
+ * @param[in] code: Scan code
+ * @param[in] arg: User argument of the configuration
+ */
+typedef void (*ir_rx_service_code_cb_t)(uint32_t index, const ir_scan_code_t *code, void *arg);
+
+/**
+ * @brief Called from the service task with every ring buffer item as received, before filtering
+ *
+ * @param[in] index: Index of the receiver in the service configuration
+ * @param[in] items: Items received
+ * @param[in] num_items: Number of items
+ * @param[in] arg: User argument of the configuration
+ */
+typedef void (*ir_rx_service_items_cb_t)(uint32_t index, const rmt_item32_t *items, size_t num_items, void *arg);
+
+/**
+ * @brief One receiver of the RX service
+ *
+ */
+typedef struct {
+    rmt_channel_t channel;        /*!< RMT RX channel, driver installed by the caller with a ring buffer */
+    ir_parser_t *parser;          /*!< Parser for the channel created by ir_parser_rmt_new* (its statistics tell
+                                       decode failures and dropped repeats apart), owned by the caller */
+    int edge_gpio;                /*!< GPIO of the receiver, timestamped on every edge to time IR_RX_LATENCY_DELIVER; -1 for none
+                                       (default). Costs an interrupt per edge for the life of the service,
+                                       the caller installs the GPIO ISR service */
+} ir_rx_service_channel_t;
+
+/**
+ * @brief Configuration of the RX service
+ *
+ */
+typedef struct {
+    ir_rx_service_channel_t channels[IR_RX_SERVICE_MAX_CHANNELS]; /*!< Receivers */
+    uint32_t num_channels;        /*!< Number of receivers */
+    uint32_t glitch_us;           /*!< Levels shorter than this are merged away before decoding, 0 to keep all */
+    ir_rx_service_code_cb_t on_code;   /*!< Scan code handler */
+    ir_rx_service_items_cb_t on_items; /*!< Raw items handler, may be NULL */
+    void *arg;                    /*!< User argument of the handlers */
+    uint32_t task_stack_size;     /*!< Stack size of the service task */
+    UBaseType_t task_priority;    /*!< Priority of the service task */
+    BaseType_t task_core;         /*!< Core the service task is pinned to, or tskNO_AFFINITY; pinned for exact latencies,
+                                       the cycle counters of the cores are not synchronized */
+    ir_trace_t *trace;            /*!< Trace receiving the delivery and decode events, NULL for none */
+} ir_rx_service_config_t;
+
+#define IR_RX_SERVICE_DEFAULT_CONFIG(chan, psr, cb)                      \
+    {                                                                    \
+        .channels = {{.channel = chan, .parser = psr, .edge_gpio = -1}}, \
+        .num_channels = 1,                                               \
+        .glitch_us = 0,                                                  \
+        .on_code = cb,                                                   \
+        .on_items = NULL,                                                \
+        .arg = NULL,                                                     \
+        .task_stack_size = 3072,                                         \
+        .task_priority = 11,                                             \
+        .task_core = tskNO_AFFINITY,                                     \
+        .trace = NULL,                                                   \
+    }
+
+/**
+ * @brief Start an RX service, receiving on all its channels
+ *
+ * A single task decodes for every channel, in the order items arrive: one parser per
+ * channel keeps the stream state and timing calibration of each receiver apart.
+ *
+ * @param[in] config: Service configuration
+ * @param[out] ret_service: Handle of the service
+ *
+ * @return
+ *      - ESP_OK: Start service successfully
+ *      - ESP_ERR_INVALID_ARG: Invalid configuration, or a channel without RX ring buffer
+ *      - ESP_ERR_NO_MEM: Out of memory
+ */
+esp_err_t ir_rx_service_new(const ir_rx_service_config_t *config, ir_rx_service_t **ret_service);
+
+#include "ir_rx_service_priv.h"
+
+/**
+ * @brief Storage of an RX service started by ir_rx_service_new_static: the service, its task and the queue set
+ *        of its ring buffers
+ *
+ */
+typedef struct {
+    ir_rx_service_t service;      /*!< Service state */
+    StaticTask_t task;            /*!< Control block of the service task */
+    StaticQueue_t ringbufs;       /*!< Queue set of the ring buffers */
+    uint8_t ringbufs_items[IR_RX_SERVICE_MAX_CHANNELS * sizeof(QueueSetMemberHandle_t)]; /*!< Slots of the queue set */
+} ir_rx_service_static_t;
+
+/**
+ * @brief Start an RX service in caller-provided storage, allocating nothing
+ *
+ * Same as ir_rx_service_new otherwise.
+ *
+ * @param[in] config: Service configuration
+ * @param[in] task_stack: Stack of the service task, config->task_stack_size bytes, must outlive the service
+ * @param[in] storage: Storage of the service, must outlive it
+ * @param[out] ret_service: Handle of the service, within storage
+ *
+ * @return
+ *      - ESP_OK: Start service successfully
+ *      - ESP_ERR_INVALID_ARG: Invalid configuration, or a channel without RX ring buffer
+ */
+esp_err_t ir_rx_service_new_static(const ir_rx_service_config_t *config, StackType_t *task_stack,
+                                   ir_rx_service_static_t *storage, ir_rx_service_t **ret_service);
+
+/**
+ * @brief Get the task of an RX service, e.g. to watch its stack high-water mark
+ *
+ * @param[in] service: Handle of the service
+ * @param[out] task: Service task
+ *
+ * @return
+ *      - ESP_OK: Get task successfully
+ *      - ESP_ERR_INVALID_ARG: Invalid arguments
+ */
+esp_err_t ir_rx_service_get_task(ir_rx_service_t *service, TaskHandle_t *task);
+
+/**
+ * @brief Get the latency histogram of a stage of reception, over all channels
+ *
+ * @param[in] service: Handle of the service
+ * @param[in] stage: Stage
+ * @param[out] hist: Copy of the histogram
+ *
+ * @return
+ *      - ESP_OK: Get histogram successfully
+ *      - ESP_ERR_INVALID_ARG: Invalid arguments
+ */
+esp_err_t ir_rx_service_get_latency(ir_rx_service_t *service, ir_rx_latency_stage_t stage, ir_latency_hist_t *hist);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,39 @@
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Layout of the RX service, included by ir_rx_service.h so that ir_rx_service_static_t can hold one.
+// Not part of the API: only ir_rx_service.c touches the fields.
+
+#include "freertos/queue.h"
+#include "freertos/ringbuf.h"
+
+typedef struct {
+    rmt_channel_t channel;
+    ir_parser_t *parser;
+    RingbufHandle_t ringbuf;
+    uint32_t glitch_ticks;
+    int edge_gpio;
+    uint32_t idle_us;           // idle threshold of the channel
+    volatile uint32_t last_edge_us; // time of the last edge on edge_gpio
+    uint32_t rejected;          // frames the parser rejected so far, to trace the bursts that add to them
+    uint32_t repeats;           // repeats the parser flagged so far, dropped or not
+} ir_rx_channel_t;
+
+struct ir_rx_service_s {
+    ir_rx_channel_t channels[IR_RX_SERVICE_MAX_CHANNELS];
+    uint32_t num_channels;
+    QueueSetHandle_t ringbufs;  // every ring buffer, so one task blocks on all of them
+    ir_rx_service_code_cb_t on_code;
+    ir_rx_service_items_cb_t on_items;
+    void *arg;
+    TaskHandle_t task;
+    ir_latency_hist_t latency[IR_RX_LATENCY_MAX]; // written by the task only
+    ir_trace_t *trace;
+};
+
+#ifdef __cplusplus
+}
+#endif
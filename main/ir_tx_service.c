@@ -0,0 +1,279 @@
+#include <stdlib.h>
+#include <string.h>
+#include <stdatomic.h>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+
+#include "esp_log.h"
+#include "soc/soc_caps.h"
+
+#include "ir_tx_service.h"
+
+static const char *TAG = "ir_tx_service";
+
+static esp_err_t ir_tx_service_transmit(ir_tx_service_t *service, const ir_tx_command_t *command)
+{
+    // One encode whatever the number of channels, by the builder of the lowest one
+    uint32_t leader = __builtin_ctz(command->channels);
+    ir_tx_channel_t *lead = &service->channels[leader];
+    ir_builder_t *builder = lead->builder;
+    rmt_item32_t *items = NULL;
+    size_t length = 0;
+    uint32_t start = ir_latency_now();
+    // Frame, gap and repeated frame in one sequence: the RMT times the gap, nothing blocks or masks interrupts.
+    // Encoded straight into one cache slot, so the cache holds as many commands as it has slots.
+    esp_err_t ret = ir_builder_rmt_build_repeated_frame(builder, command->address, command->command);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    // Fails with ESP_ERR_INVALID_STATE while every reservation is still on air
+    ret = builder->get_result(builder, &items, &length);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    ir_latency_since(&service->latency[IR_TX_LATENCY_BUILD], start);
+    lead->mask = command->channels;
+    atomic_store(&lead->remaining, __builtin_popcount(command->channels));
+    for (uint32_t mask = command->channels; mask; mask &= mask - 1) {
+        service->channels[__builtin_ctz(mask)].leader = leader;
+    }
+#if SOC_RMT_SUPPORT_TX_SYNCHRO
+    // Grouped channels start together once the last of them is written
+    for (uint32_t mask = command->channels; mask && (command->channels & (command->channels - 1)); mask &= mask - 1) {
+        rmt_add_channel_to_group(service->channels[__builtin_ctz(mask)].channel);
+    }
+#endif
+    // Every channel reads the same items, they stay reserved until the last one is done
+    lead->sent_at = ir_latency_now();
+    for (uint32_t mask = command->channels; mask; mask &= mask - 1) {
+        rmt_channel_t channel = service->channels[__builtin_ctz(mask)].channel;
+        ir_trace_record(service->trace, IR_TRACE_TX_START, channel, command->command);
+        rmt_write_items(channel, items, length, false);
+    }
+    return ESP_OK;
+}
+
+static void ir_tx_service_task(void *arg)
+{
+    ir_tx_service_t *service = (ir_tx_service_t *)arg;
+    ir_tx_command_t command;
+    uint32_t free_channels = IR_TX_SERVICE_CHANNEL(service->num_channels) - 1;
+    while (1) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        uint32_t done = atomic_exchange(&service->done, 0);
+#if SOC_RMT_SUPPORT_TX_SYNCHRO
+        for (uint32_t mask = done; mask; mask &= mask - 1) {
+            rmt_remove_channel_from_group(service->channels[__builtin_ctz(mask)].channel);
+        }
+#endif
+        free_channels |= done;
+        // Start a command on every channel that is free; until its channels are, newer commands keep
+        // replacing pending ones in the queue. A command stays queued until it is on air.
+        uint32_t blocked = 0;
+        while (1) {
+            xSemaphoreTake(service->lock, portMAX_DELAY);
+            esp_err_t ret = ir_tx_queue_peek_ready(&service->queue, free_channels & ~blocked, &command);
+            xSemaphoreGive(service->lock);
+            if (ret != ESP_OK) {
+                break;
+            }
+            ret = ir_tx_service_transmit(service, &command);
+            if (ret == ESP_ERR_INVALID_STATE) {
+                // No frame slot free: retried once a transmission ends and releases one
+                blocked |= command.channels;
+                continue;
+            }
+            xSemaphoreTake(service->lock, portMAX_DELAY);
+            ir_tx_queue_commit(&service->queue, &command);
+            if (ret == ESP_OK) {
+                ir_tx_queue_mark_sent(&service->queue, &command);
+                service->sent++;
+            }
+            xSemaphoreGive(service->lock);
+            if (ret != ESP_OK) {
+                // The builder can't encode it, retrying won't help
+                ESP_LOGW(TAG, "drop command 0x%x to unit 0x%x: %s", command.command, command.unit, esp_err_to_name(ret));
+                continue;
+            }
+            free_channels &= ~command.channels;
+            ESP_LOGD(TAG, "Send command 0x%x to address 0x%x on channels 0x%x", command.command, command.address,
+                     command.channels);
+        }
+    }
+}
+
+// Every channel of a broadcast reads the items of one builder, they must stay reserved until all are done
+static bool ir_tx_service_check_config(const ir_tx_service_config_t *config)
+{
+    if (!config || !config->num_channels || config->num_channels > IR_TX_SERVICE_MAX_CHANNELS) {
+        return false;
+    }
+    for (uint32_t i = 0; i < config->num_channels; i++) {
+        uint32_t flags = 0;
+        if (!config->channels[i].builder || ir_builder_rmt_get_flags(config->channels[i].builder, &flags) != ESP_OK ||
+                !(flags & IR_TOOLS_FLAGS_TX_RELEASE)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static void ir_tx_service_init(ir_tx_service_t *service, const ir_tx_service_config_t *config)
+{
+    for (uint32_t i = 0; i < config->num_channels; i++) {
+        service->channels[i].channel = config->channels[i].channel;
+        service->channels[i].builder = config->channels[i].builder;
+        service->channels[i].leader = i;
+    }
+    service->num_channels = config->num_channels;
+    service->trace = config->trace;
+    ir_tx_queue_init(&service->queue);
+    for (uint32_t i = 0; i < IR_TX_LATENCY_MAX; i++) {
+        ir_latency_init(&service->latency[i]);
+    }
+}
+
+esp_err_t ir_tx_service_new(const ir_tx_service_config_t *config, ir_tx_service_t **ret_service)
+{
+    if (!ret_service || !ir_tx_service_check_config(config)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    ir_tx_service_t *service = calloc(1, sizeof(ir_tx_service_t));
+    if (!service) {
+        return ESP_ERR_NO_MEM;
+    }
+    ir_tx_service_init(service, config);
+    service->lock = xSemaphoreCreateMutex();
+    if (!service->lock) {
+        free(service);
+        return ESP_ERR_NO_MEM;
+    }
+    if (xTaskCreatePinnedToCore(ir_tx_service_task, "ir_tx_service", config->task_stack_size, service,
+                                config->task_priority, &service->task, config->task_core) != pdPASS) {
+        vSemaphoreDelete(service->lock);
+        free(service);
+        return ESP_ERR_NO_MEM;
+    }
+    *ret_service = service;
+    return ESP_OK;
+}
+
+esp_err_t ir_tx_service_new_static(const ir_tx_service_config_t *config, StackType_t *task_stack,
+                                   ir_tx_service_static_t *storage, ir_tx_service_t **ret_service)
+{
+    if (!task_stack || !storage || !ret_service || !ir_tx_service_check_config(config)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    ir_tx_service_t *service = &storage->service;
+    memset(storage, 0, sizeof(*storage));
+    ir_tx_service_init(service, config);
+    // Neither can fail with the buffers given
+    service->lock = xSemaphoreCreateMutexStatic(&storage->lock);
+    service->task = xTaskCreateStaticPinnedToCore(ir_tx_service_task, "ir_tx_service", config->task_stack_size, service,
+                                                  config->task_priority, task_stack, &storage->task, config->task_core);
+    *ret_service = service;
+    return ESP_OK;
+}
+
+// Channel mask of a command: 0 is the first channel, channels the service doesn't have are an error
+static bool ir_tx_service_route(const ir_tx_service_t *service, uint32_t *channels)
+{
+    if (!*channels) {
+        *channels = IR_TX_SERVICE_CHANNEL(0);
+    }
+    return !(*channels >> service->num_channels);
+}
+
+esp_err_t ir_tx_service_send(ir_tx_service_t *service, const ir_tx_command_t *command)
+{
+    if (!service || !command) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    ir_tx_command_t routed = *command;
+    if (!ir_tx_service_route(service, &routed.channels)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    xSemaphoreTake(service->lock, portMAX_DELAY);
+    esp_err_t ret = ir_tx_queue_push(&service->queue, &routed, NULL);
+    xSemaphoreGive(service->lock);
+    if (ret == ESP_OK) {
+        xTaskNotifyGive(service->task);
+    }
+    return ret;
+}
+
+esp_err_t ir_tx_service_send_changed(ir_tx_service_t *service, const ir_tx_command_t *command)
+{
+    if (!service || !command) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    ir_tx_command_t routed = *command;
+    if (!ir_tx_service_route(service, &routed.channels)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    bool skipped = false;
+    xSemaphoreTake(service->lock, portMAX_DELAY);
+    esp_err_t ret = ir_tx_queue_push_changed(&service->queue, &routed, &skipped);
+    xSemaphoreGive(service->lock);
+    if (ret == ESP_OK && !skipped) {
+        xTaskNotifyGive(service->task);
+    }
+    return ret;
+}
+
+esp_err_t ir_tx_service_tx_end_from_isr(ir_tx_service_t *service, rmt_channel_t channel, BaseType_t *task_woken)
+{
+    // No logging, no lock: runs in the RMT interrupt
+    uint32_t index = 0;
+    while (index < service->num_channels && service->channels[index].channel != channel) {
+        index++;
+    }
+    if (index == service->num_channels) {
+        return ESP_ERR_NOT_FOUND;
+    }
+    ir_tx_channel_t *lead = &service->channels[service->channels[index].leader];
+    uint32_t remaining = atomic_fetch_sub(&lead->remaining, 1) - 1;
+    ir_trace_record(service->trace, IR_TRACE_TX_END, channel, remaining);
+    if (remaining) {
+        return ESP_OK;
+    }
+    // Last channel of the transmission: its frame and all its channels are free again
+    ir_latency_since(&service->latency[IR_TX_LATENCY_SEND], lead->sent_at);
+    ir_builder_rmt_release_result(lead->builder);
+    atomic_fetch_or(&service->done, lead->mask);
+    vTaskNotifyGiveFromISR(service->task, task_woken);
+    return ESP_OK;
+}
+
+esp_err_t ir_tx_service_get_latency(ir_tx_service_t *service, ir_tx_latency_stage_t stage, ir_latency_hist_t *hist)
+{
+    if (!service || stage >= IR_TX_LATENCY_MAX || !hist) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    *hist = service->latency[stage];
+    return ESP_OK;
+}
+
+esp_err_t ir_tx_service_get_task(ir_tx_service_t *service, TaskHandle_t *task)
+{
+    if (!service || !task) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    *task = service->task;
+    return ESP_OK;
+}
+
+esp_err_t ir_tx_service_get_stats(ir_tx_service_t *service, uint32_t *sent, uint32_t *coalesced, uint32_t *skipped)
+{
+    if (!service || !sent || !coalesced || !skipped) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    xSemaphoreTake(service->lock, portMAX_DELAY);
+    *sent = service->sent;
+    *coalesced = service->queue.coalesced;
+    *skipped = service->queue.skipped;
+    xSemaphoreGive(service->lock);
+    return ESP_OK;
+}
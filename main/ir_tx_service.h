@@ -0,0 +1,211 @@
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_err.h"
+#include "driver/rmt.h"
+#include "ir_tools.h"
+#include "ir_tx_queue.h"
+#include "ir_latency.h"
+#include "ir_trace.h"
+
+#define IR_TX_SERVICE_MAX_CHANNELS (8)                  /*!< RMT TX channels one service drives */
+#define IR_TX_SERVICE_CHANNEL(index) (1UL << (index))   /*!< Channel mask of one channel of the service */
+
+/**
+ * @brief Stages of transmission timed by the TX service
+ *
+ */
+typedef enum {
+    IR_TX_LATENCY_BUILD,  /*!< Encoding a command: ir_builder_rmt_build_repeated_frame and get_result */
+    IR_TX_LATENCY_SEND,   /*!< Items written to the last channel of the command done, frame, gap and repeated frame included */
+    IR_TX_LATENCY_MAX,
+} ir_tx_latency_stage_t;
+
+/**
+ * @brief Queued TX service: one task dispatching commands to several RMT channels, each with its builder
+ *
+ */
+typedef struct ir_tx_service_s ir_tx_service_t;
+
+/**
+ * @brief One emitter of the TX service
+ *
+ */
+typedef struct {
+    rmt_channel_t channel;        /*!< RMT TX channel, driver installed by the caller */
+    ir_builder_t *builder;        /*!< Builder for the channel, owned by the caller */
+} ir_tx_service_channel_t;
+
+/**
+ * @brief Configuration of the TX service
+ *
+ */
+typedef struct {
+    ir_tx_service_channel_t channels[IR_TX_SERVICE_MAX_CHANNELS]; /*!< Emitters, indexed by channel masks */
+    uint32_t num_channels;        /*!< Number of emitters */
+    uint32_t task_stack_size;     /*!< Stack size of the service task */
+    UBaseType_t task_priority;    /*!< Priority of the service task */
+    BaseType_t task_core;         /*!< Core the service task is pinned to, or tskNO_AFFINITY; pinned to the core of the RMT
+                                       interrupt for exact IR_TX_LATENCY_SEND, the cycle counters of the cores are not synchronized */
+    ir_trace_t *trace;            /*!< Trace receiving the TX start and end events, NULL for none */
+} ir_tx_service_config_t;
+
+#define IR_TX_SERVICE_DEFAULT_CONFIG(chan, bld)         \
+    {                                                   \
+        .channels = {{.channel = chan, .builder = bld}},\
+        .num_channels = 1,                              \
+        .task_stack_size = 2048,                        \
+        .task_priority = 10,                            \
+        .task_core = tskNO_AFFINITY,                    \
+        .trace = NULL,                                  \
+    }
+
+/**
+ * @brief Start a TX service
+ *
+ * Every builder must be created with IR_TOOLS_FLAGS_TX_RELEASE: the items of a frame stay
+ * reserved until each channel sending them is done.
+ *
+ * @param[in] config: Service configuration
+ * @param[out] ret_service: Handle of the service
+ *
+ * @return
+ *      - ESP_OK: Start service successfully
+ *      - ESP_ERR_INVALID_ARG: Invalid configuration, or a builder without IR_TOOLS_FLAGS_TX_RELEASE
+ *      - ESP_ERR_NO_MEM: Out of memory
+ */
+esp_err_t ir_tx_service_new(const ir_tx_service_config_t *config, ir_tx_service_t **ret_service);
+
+#include "ir_tx_service_priv.h"
+
+/**
+ * @brief Storage of a TX service started by ir_tx_service_new_static: the service, its task and its lock
+ *
+ */
+typedef struct {
+    ir_tx_service_t service;      /*!< Service state */
+    StaticTask_t task;            /*!< Control block of the service task */
+    StaticSemaphore_t lock;       /*!< Lock of the command queue */
+} ir_tx_service_static_t;
+
+/**
+ * @brief Start a TX service in caller-provided storage, allocating nothing
+ *
+ * Same as ir_tx_service_new otherwise.
+ *
+ * @param[in] config: Service configuration
+ * @param[in] task_stack: Stack of the service task, config->task_stack_size bytes, must outlive the service
+ * @param[in] storage: Storage of the service, must outlive it
+ * @param[out] ret_service: Handle of the service, within storage
+ *
+ * @return
+ *      - ESP_OK: Start service successfully
+ *      - ESP_ERR_INVALID_ARG: Invalid configuration, or a builder without IR_TOOLS_FLAGS_TX_RELEASE
+ */
+esp_err_t ir_tx_service_new_static(const ir_tx_service_config_t *config, StackType_t *task_stack,
+                                   ir_tx_service_static_t *storage, ir_tx_service_t **ret_service);
+
+/**
+ * @brief Queue a command for transmission, from any task
+ *
+ * A pending command to the same unit is replaced: only the newest state goes out.
+ * Commands are sent by priority as soon as their channels are free, the ending code of the
+ * previous frame providing the inter-frame gap; channels transmit independently. A command
+ * for several channels is encoded once and written to each of them. Where the RMT supports
+ * TX synchronization (SOC_RMT_SUPPORT_TX_SYNCHRO) they start together; otherwise, as on
+ * ESP32, each starts once its items are written, one channel after the other, so later
+ * channels lag the first by tens of microseconds each (see the IR_TRACE_TX_START events).
+ * A command whose frame can't be reserved, every reservation of the builder being on air,
+ * stays queued and is retried once a transmission ends; one the builder can't encode is dropped.
+ *
+ * @param[in] service: Handle of the service
+ * @param[in] command: Command to send, channels 0 meaning the first channel
+ *
+ * @return
+ *      - ESP_OK: Queue command successfully
+ *      - ESP_ERR_INVALID_ARG: Invalid arguments
+ *      - ESP_ERR_NO_MEM: Queue full
+ */
+esp_err_t ir_tx_service_send(ir_tx_service_t *service, const ir_tx_command_t *command);
+
+/**
+ * @brief Queue a command carrying the full state of its unit, e.g. an aircon code, from any task
+ *
+ * The command is skipped entirely when the unit was last sent the same command, and a
+ * pending different command to the unit is dropped with it (see ir_tx_queue_push_changed).
+ *
+ * @param[in] service: Handle of the service
+ * @param[in] command: Command to send, channels 0 meaning the first channel
+ *
+ * @return
+ *      - ESP_OK: Queue or skip command successfully
+ *      - ESP_ERR_INVALID_ARG: Invalid arguments
+ *      - ESP_ERR_NO_MEM: Queue full
+ */
+esp_err_t ir_tx_service_send_changed(ir_tx_service_t *service, const ir_tx_command_t *command);
+
+/**
+ * @brief Report the end of a transmission, from the RMT TX end callback
+ *
+ * Frees the channel for the next command and, once every channel of a broadcast is done,
+ * releases the frame of its builder (see IR_TOOLS_FLAGS_TX_RELEASE). The service can't
+ * dispatch to a channel again until this is called for it.
+ *
+ * @param[in] service: Handle of the service
+ * @param[in] channel: Channel the callback is for
+ * @param[out] task_woken: Set if the service task must run, for portYIELD_FROM_ISR
+ *
+ * @return
+ *      - ESP_OK: Report end successfully
+ *      - ESP_ERR_NOT_FOUND: Channel not driven by the service
+ */
+esp_err_t ir_tx_service_tx_end_from_isr(ir_tx_service_t *service, rmt_channel_t channel, BaseType_t *task_woken);
+
+/**
+ * @brief Get the task of a TX service, e.g. to watch its stack high-water mark
+ *
+ * @param[in] service: Handle of the service
+ * @param[out] task: Service task
+ *
+ * @return
+ *      - ESP_OK: Get task successfully
+ *      - ESP_ERR_INVALID_ARG: Invalid arguments
+ */
+esp_err_t ir_tx_service_get_task(ir_tx_service_t *service, TaskHandle_t *task);
+
+/**
+ * @brief Get the latency histogram of a stage of transmission, over all channels
+ *
+ * @param[in] service: Handle of the service
+ * @param[in] stage: Stage
+ * @param[out] hist: Copy of the histogram
+ *
+ * @return
+ *      - ESP_OK: Get histogram successfully
+ *      - ESP_ERR_INVALID_ARG: Invalid arguments
+ */
+esp_err_t ir_tx_service_get_latency(ir_tx_service_t *service, ir_tx_latency_stage_t stage, ir_latency_hist_t *hist);
+
+/**
+ * @brief Get counters of a TX service
+ *
+ * @param[in] service: Handle of the service
+ * @param[out] sent: Commands transmitted, a broadcast counting once
+ * @param[out] coalesced: Commands that replaced a pending one to the same unit
+ * @param[out] skipped: Commands skipped because the unit already had that state
+ *
+ * @return
+ *      - ESP_OK: Get counters successfully
+ *      - ESP_ERR_INVALID_ARG: Invalid arguments
+ */
+esp_err_t ir_tx_service_get_stats(ir_tx_service_t *service, uint32_t *sent, uint32_t *coalesced, uint32_t *skipped);
+
+#ifdef __cplusplus
+}
+#endif
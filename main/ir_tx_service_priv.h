@@ -0,0 +1,36 @@
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Layout of the TX service, included by ir_tx_service.h so that ir_tx_service_static_t can hold one.
+// Not part of the API: only ir_tx_service.c touches the fields.
+
+#include <stdatomic.h>
+#include "freertos/semphr.h"
+
+typedef struct {
+    rmt_channel_t channel;
+    ir_builder_t *builder;
+    uint32_t leader;          // channel whose builder encoded the frame on air, it keeps the state of the transmission
+    uint32_t mask;            // leader only: channels of its transmission
+    atomic_uint remaining;    // leader only: channels of its transmission still sending
+    uint32_t sent_at;         // leader only: cycle count when its transmission was written
+} ir_tx_channel_t;
+
+struct ir_tx_service_s {
+    ir_tx_channel_t channels[IR_TX_SERVICE_MAX_CHANNELS];
+    uint32_t num_channels;
+    SemaphoreHandle_t lock;   // guards queue and counters
+    TaskHandle_t task;
+    ir_tx_queue_t queue;
+    uint32_t sent;
+    atomic_uint done;         // channels whose transmission ended, collected by the task
+    ir_latency_hist_t latency[IR_TX_LATENCY_MAX]; // build written by the task, send by the TX end ISR
+    ir_trace_t *trace;
+};
+
+#ifdef __cplusplus
+}
+#endif
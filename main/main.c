@@ -6,12 +6,12 @@
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
 #include "freertos/timers.h"
-#include "freertos/semphr.h"
 
 #include "esp_system.h"
 #include "esp_spi_flash.h"
 #include "esp_err.h"
 #include "esp_log.h"
+#include "esp_timer.h"
 
 
 #include "driver/rmt.h"
@@ -19,21 +19,144 @@
 #include "driver/timer.h"
 
 #include "ir_tools.h"
+#include "ir_tx_service.h"
+#include "ir_rx_service.h"
+#include "ir_capture.h"
+#include "ir_trace.h"
 
 static const char *TAG = "aircon";
 
-static const rmt_channel_t tx_rmt_chan = RMT_CHANNEL_0;
-static const rmt_channel_t rx_rmt_chan = RMT_CHANNEL_1;
+// One emitter per zone, each on its own RMT channel
+static const struct {
+    rmt_channel_t channel;
+    gpio_num_t gpio;
+} tx_emitters[] = {
+    {RMT_CHANNEL_0, GPIO_NUM_2},
+    {RMT_CHANNEL_2, GPIO_NUM_4},
+};
 
-SemaphoreHandle_t xSemaphoreRmtTx;
-SemaphoreHandle_t xSemaphoreRmtRx;
+// Receivers covering the zones, all decoded by the RX service
+static const struct {
+    rmt_channel_t channel;
+    gpio_num_t gpio;
+} rx_receivers[] = {
+    {RMT_CHANNEL_1, GPIO_NUM_5},
+    {RMT_CHANNEL_3, GPIO_NUM_18},
+};
+
+// Wi-Fi and logging run on the protocol core: decoding gets the other one to itself
+#ifndef IR_RX_CORE
+#if CONFIG_FREERTOS_UNICORE || CONFIG_ESP32_WIFI_TASK_PINNED_TO_CORE_1
+#define IR_RX_CORE (0)
+#else
+#define IR_RX_CORE (1)
+#endif
+#endif
+
+// Frames are timed by the RMT, so the TX side shares the protocol core
+#ifndef IR_TX_CORE
+#if CONFIG_FREERTOS_UNICORE
+#define IR_TX_CORE (0)
+#else
+#define IR_TX_CORE (!IR_RX_CORE)
+#endif
+#endif
+
+#ifndef IR_REPORT_MS
+#define IR_REPORT_MS (60000) // period of the stack high-water and latency report, 0 for none
+#endif
+
+#ifndef IR_TRACE_DRAIN_MS
+#define IR_TRACE_DRAIN_MS (100) // period of the trace drain task, the ring must hold the events of one period
+#endif
+#define IR_TRACE_SLOTS (128)    // power of 2
+
+// Tasks whose stack high-water mark is reported, each slot written once by the task creating it
+enum {
+    STACK_TRACE,
+    STACK_TX,
+    STACK_TX_SERVICE,
+    STACK_RX_SERVICE,
+    STACK_REPORT,
+    STACK_MAX,
+};
+static TaskHandle_t s_stack_tasks[STACK_MAX];
+static ir_tx_service_t *s_tx_service;
+static ir_rx_service_t *s_rx_service;
+
+// Tasks, their stacks and the services live in static storage too, nothing of the IR stack is allocated at run
+// time. StackType_t is a byte on ESP32, stack sizes are in bytes.
+static StackType_t s_trace_stack[2560];
+static StackType_t s_tx_stack[2048];
+static StackType_t s_report_stack[2560];
+static StackType_t s_tx_service_stack[2048];
+static StackType_t s_rx_service_stack[3072];
+static StaticTask_t s_task_buffers[STACK_MAX];
+static ir_tx_service_static_t s_tx_service_storage;
+static ir_rx_service_static_t s_rx_service_storage;
+
+// Timeline of TX and RX events, recorded by the services and the TX end interrupt, logged by trace_task
+static ir_trace_slot_t s_trace_slots[IR_TRACE_SLOTS];
+static ir_trace_t s_trace;
+
+// Builders and parsers live in static storage, so reconfiguring them never touches the heap
+#define IR_TX_BUILDER_ITEMS (128) // frame, gap and repeated frame in one result
+static IR_TOOLS_STATIC_STORAGE(s_builder_storage[sizeof(tx_emitters) / sizeof(tx_emitters[0])],
+                               IR_BUILDER_RMT_STATIC_SIZE(IR_TX_BUILDER_ITEMS));
+static const ir_protocol_t *const s_rx_protocols[] = {&ir_protocol_samsung, &ir_protocol_nec};
+#define IR_RX_NUM_PROTOCOLS (sizeof(s_rx_protocols) / sizeof(s_rx_protocols[0]))
+static IR_TOOLS_STATIC_STORAGE(s_parser_storage[sizeof(rx_receivers) / sizeof(rx_receivers[0])],
+                               IR_PARSER_DISPATCH_STATIC_SIZE(IR_RX_NUM_PROTOCOLS));
+
+#ifndef IR_RX_GLITCH_US
+#define IR_RX_GLITCH_US (100) // received levels shorter than this are ambient light, not IR frames
+#endif
+
+#ifndef IR_RX_EDGE_TIMING
+#define IR_RX_EDGE_TIMING (0) // 1: timestamp every receiver edge to report rx deliver, at the cost of an interrupt per edge
+#endif
+
+#ifndef IR_RX_CAPTURE_BYTES
+#define IR_RX_CAPTURE_BYTES (0) // >0: record received items, dumping the capture as hex once this many bytes are full
+#endif
+
+#if IR_RX_CAPTURE_BYTES
+static uint32_t s_capture_buffer[IR_RX_CAPTURE_BYTES / sizeof(uint32_t)];
+static ir_capture_writer_t s_capture;
+
+/**
+ * @brief Record a ring buffer item of the first receiver
+ *
+ * Extract the capture from the log for ir_replay with:
+ * grep 'ir_capture:' log | sed 's/.*ir_capture: //' | xxd -r -p > capture.bin
+ */
+static void ir_rx_capture(const rmt_item32_t *items, uint32_t num_items)
+{
+    int64_t now_us = esp_timer_get_time();
+    if (s_capture.buffer && ir_capture_write(&s_capture, now_us, items, num_items) == ESP_OK) {
+        return;
+    }
+    if (s_capture.buffer) {
+        // Full: dump it and start over
+        ESP_LOG_BUFFER_HEX("ir_capture", s_capture.buffer, s_capture.length);
+    }
+    uint32_t counter_clk_hz = 0;
+    ESP_ERROR_CHECK(rmt_get_counter_clock(rx_receivers[0].channel, &counter_clk_hz));
+    ESP_ERROR_CHECK(ir_capture_writer_init(&s_capture, s_capture_buffer, sizeof(s_capture_buffer), counter_clk_hz));
+    ir_capture_write(&s_capture, now_us, items, num_items);
+}
+#endif
 
 
 static void localTxEndCallback(rmt_channel_t channel, void *arg)
 {
-    static BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+    BaseType_t xHigherPriorityTaskWoken = pdFALSE;
 
-    xSemaphoreGiveFromISR(xSemaphoreRmtTx, &xHigherPriorityTaskWoken);
+    // The service frees the channel, and the frame just sent once every channel of a broadcast is done
+    ir_tx_service_tx_end_from_isr((ir_tx_service_t *)arg, channel, &xHigherPriorityTaskWoken);
+    if (xHigherPriorityTaskWoken) {
+        portYIELD_FROM_ISR();
+    }
 }
 
 /**
@@ -43,115 +166,192 @@ static void localTxEndCallback(rmt_channel_t channel, void *arg)
 static void ir_tx_task(void *arg)
 {
     uint32_t addr = 0xB24D;
-    // uint32_t cmd = (0xBF40 << 16) | 0x00FF;
+    // Codes captured from the unit's remote, each carrying the full state of the unit
     uint32_t arr_cmd[2] = {0xdd2207f8, 0xf80721de};
-    rmt_item32_t *items = NULL;
-    size_t length = 0;
+    const uint32_t num_emitters = sizeof(tx_emitters) / sizeof(tx_emitters[0]);
 
-    rmt_config_t rmt_tx_config = RMT_DEFAULT_CONFIG_TX(GPIO_NUM_2, tx_rmt_chan);
-    rmt_tx_config.tx_config.carrier_en = true;
-    rmt_tx_config.tx_config.carrier_freq_hz = 37900;
-    rmt_config(&rmt_tx_config);
-    rmt_driver_install(tx_rmt_chan, 0, 0);
+    // One RMT channel and builder per emitter, the service drives them independently
+    ir_tx_service_config_t tx_service_config = IR_TX_SERVICE_DEFAULT_CONFIG(tx_emitters[0].channel, NULL);
+    tx_service_config.num_channels = num_emitters;
+    for (uint32_t i = 0; i < num_emitters; i++) {
+        rmt_config_t rmt_tx_config = RMT_DEFAULT_CONFIG_TX(tx_emitters[i].gpio, tx_emitters[i].channel);
+        rmt_tx_config.tx_config.carrier_en = true;
+        rmt_tx_config.tx_config.carrier_freq_hz = 37900;
+        rmt_config(&rmt_tx_config);
+        rmt_driver_install(tx_emitters[i].channel, 0, 0);
 
-    __unused rmt_tx_end_callback_t previous = rmt_register_tx_end_callback(localTxEndCallback, (void *)&addr);
+        ir_builder_config_t ir_builder_config = IR_BUILDER_DEFAULT_CONFIG((ir_dev_t)tx_emitters[i].channel);
+        ir_builder_config.buffer_size = IR_TX_BUILDER_ITEMS;
+        ir_builder_config.flags |= IR_TOOLS_FLAGS_PROTO_EXT; // Using extended IR protocols (both NEC and RC5 have extended version)
+        ir_builder_config.flags |= IR_TOOLS_FLAGS_TX_RELEASE; // Frames stay reserved until the service releases them
 
-    ir_builder_config_t ir_builder_config = IR_BUILDER_DEFAULT_CONFIG((ir_dev_t)tx_rmt_chan);
-    ir_builder_config.flags |= IR_TOOLS_FLAGS_PROTO_EXT; // Using extended IR protocols (both NEC and RC5 have extended version)
+        tx_service_config.channels[i].channel = tx_emitters[i].channel;
+        tx_service_config.channels[i].builder = ir_builder_rmt_new_static(&ir_builder_config, &ir_protocol_samsung,
+                                                                          s_builder_storage[i], sizeof(s_builder_storage[i]));
+    }
 
-    ir_builder_t* ir_builder = ir_builder_rmt_new_samsung(&ir_builder_config);
+    ir_tx_service_t *tx_service = NULL;
+    tx_service_config.task_stack_size = sizeof(s_tx_service_stack);
+    tx_service_config.task_core = IR_TX_CORE;
+    tx_service_config.trace = &s_trace;
+    ESP_ERROR_CHECK(ir_tx_service_new_static(&tx_service_config, s_tx_service_stack, &s_tx_service_storage, &tx_service));
+    ESP_ERROR_CHECK(ir_tx_service_get_task(tx_service, &s_stack_tasks[STACK_TX_SERVICE]));
+    s_tx_service = tx_service;
+    __unused rmt_tx_end_callback_t previous = rmt_register_tx_end_callback(localTxEndCallback, (void *)tx_service);
 
     uint8_t cmd_num = 0;
+    TickType_t last_wake_time = xTaskGetTickCount();
     while (1) {
-        uint32_t cmd = arr_cmd[cmd_num];
-        vTaskDelay(pdMS_TO_TICKS(3000));
-        ESP_LOGI(TAG, "Send command 0x%x to address 0x%x", cmd, addr);
-        vTaskDelay(pdMS_TO_TICKS(500));
-        // Send new key code
-        ESP_ERROR_CHECK(ir_builder->build_frame(ir_builder, addr, cmd));
-        ESP_ERROR_CHECK(ir_builder->get_result(ir_builder, &items, &length));
-        //To send data according to the waveform items.
-        rmt_write_items(tx_rmt_chan, items, length, true);
-#ifdef HACK_DELAY_5500US
-        // Plan here was to delay for requisite 5500us for repeat send
-        // Rather opted to make the ending code high ticks = 5500us
-        vTaskDelay(pdMS_TO_TICKS(5));
-        taskDISABLE_INTERRUPTS();
-        ets_delay_us(500);
-        taskENABLE_INTERRUPTS();
-#endif
-        rmt_write_items(tx_rmt_chan, items, length, false);
+        // Demo control plane: any task may queue commands, a newer command for the unit replaces a pending one.
+        // Each zone's unit has its own emitter, the commands go out concurrently; the last command is broadcast
+        // to every zone with a single encode.
+        vTaskDelayUntil(&last_wake_time, pdMS_TO_TICKS(3500));
+        for (uint32_t i = 0; i < num_emitters; i++) {
+            ir_tx_command_t command = {
+                .unit = i,
+                .address = addr,
+                .command = arr_cmd[(cmd_num + i) % 2],
+                .priority = 0,
+                .channels = IR_TX_SERVICE_CHANNEL(i),
+            };
+            ESP_ERROR_CHECK(ir_tx_service_send(tx_service, &command));
+        }
+        vTaskDelayUntil(&last_wake_time, pdMS_TO_TICKS(3500));
+        ir_tx_command_t command = {
+            .unit = num_emitters,
+            .address = addr,
+            .command = arr_cmd[cmd_num],
+            .priority = 0,
+            .channels = IR_TX_SERVICE_CHANNEL(num_emitters) - 1,
+        };
+        ESP_ERROR_CHECK(ir_tx_service_send(tx_service, &command));
         cmd_num += 1;
         cmd_num %= 2;
 
         if (0) {break;}
     }
-    ir_builder->del(ir_builder);
-    rmt_driver_uninstall(tx_rmt_chan);
+    for (uint32_t i = 0; i < num_emitters; i++) {
+        tx_service_config.channels[i].builder->del(tx_service_config.channels[i].builder);
+        rmt_driver_uninstall(tx_emitters[i].channel);
+    }
     vTaskDelete(NULL);
 }
 
 
-static void ir_rx_task(void *arg)
+static void ir_rx_code(uint32_t index, const ir_scan_code_t *code, void *arg)
 {
-    uint32_t addr = 0;
-    uint32_t cmd = 0;
-    size_t length = 0;
-    bool repeat = false;
-    RingbufHandle_t rb = NULL;
-    rmt_item32_t *items = NULL;
-
-    rmt_config_t rmt_rx_config = RMT_DEFAULT_CONFIG_RX(GPIO_NUM_5, rx_rmt_chan);
-    rmt_rx_config.rx_config.idle_threshold = 5100;
-    rmt_config(&rmt_rx_config);
-    rmt_driver_install(rx_rmt_chan, 1000, 0);
-
-    ir_parser_config_t ir_parser_config = IR_PARSER_DEFAULT_CONFIG((ir_dev_t)rx_rmt_chan);
-    ir_parser_config.margin_us = 200;
-    ir_parser_config.flags |= IR_TOOLS_FLAGS_PROTO_EXT; // Using extended IR protocols
-    ir_parser_t *ir_parser = NULL;
-    ir_parser = ir_parser_rmt_new_samsung(&ir_parser_config);
-
-    //get RMT RX ringbuffer
-    rmt_get_ringbuf_handle(rx_rmt_chan, &rb);
-    assert(rb != NULL);
-    // Start receive
-    rmt_rx_start(rx_rmt_chan, true);
-    while (1) 
-    {
-        items = (rmt_item32_t *) xRingbufferReceive(rb, &length, portMAX_DELAY);
-        if (items)
-        {
-            length /= 4; // one RMT = 4 Bytes
-            if (ir_parser->input(ir_parser, items, length) == ESP_OK) 
-            {
-                // xSemaphoreGive(xSemaphoreRmtRx);
-                if (ir_parser->get_scan_code(ir_parser, &addr, &cmd, &repeat) == ESP_OK)
-                {
-                    ESP_LOGI(TAG, "Scan Code %s --- addr: 0x%x cmd: 0x%x", repeat ? "(repeat)" : "", addr, cmd);
-                }
+    ESP_LOGI(TAG, "Scan Code %s %s --- receiver %u addr: 0x%x cmd: 0x%x", code->protocol->name,
+             code->repeat ? "(repeat)" : "", index, code->address, code->command);
+}
+
+#if IR_RX_CAPTURE_BYTES
+static void ir_rx_items(uint32_t index, const rmt_item32_t *items, size_t num_items, void *arg)
+{
+    if (index == 0) {
+        ir_rx_capture(items, num_items);
+    }
+}
+#endif
+
+/**
+ * @brief Start receiving: every receiver with its own parser, one decode task for all of them
+ *
+ */
+static ir_rx_service_t *ir_rx_start(void)
+{
+    const uint32_t num_receivers = sizeof(rx_receivers) / sizeof(rx_receivers[0]);
+    ir_rx_service_config_t rx_service_config = IR_RX_SERVICE_DEFAULT_CONFIG(rx_receivers[0].channel, NULL, ir_rx_code);
+    rx_service_config.num_channels = num_receivers;
+    for (uint32_t i = 0; i < num_receivers; i++) {
+        rmt_config_t rmt_rx_config = RMT_DEFAULT_CONFIG_RX(rx_receivers[i].gpio, rx_receivers[i].channel);
+        rmt_rx_config.rx_config.idle_threshold = 5100;
+        rmt_rx_config.rx_config.filter_en = true;
+        rmt_rx_config.rx_config.filter_ticks_thresh = 255; // hardware filter limit, about 3 us of APB clock
+        rmt_config(&rmt_rx_config);
+        rmt_driver_install(rx_receivers[i].channel, 1000, 0);
+
+        ir_parser_config_t ir_parser_config = IR_PARSER_DEFAULT_CONFIG((ir_dev_t)rx_receivers[i].channel);
+        ir_parser_config.margin_us = 200;
+        ir_parser_config.repeat_window_ms = 200; // the remote sends every frame twice, about 100 ms apart
+        ir_parser_config.flags |= IR_TOOLS_FLAGS_DROP_REPEAT; // so only the first one reaches the application
+        ir_parser_config.flags |= IR_TOOLS_FLAGS_PROTO_EXT; // Using extended IR protocols
+        ir_parser_config.flags |= IR_TOOLS_FLAGS_STREAM; // Frames may be split across or merged within ring buffer items
+        ir_parser_config.flags |= IR_TOOLS_FLAGS_CALIBRATE; // Windows follow the timing of the remote instead of widening margin_us
+        // Units of several brands share the receiver, each frame goes to the parser of its protocol
+        rx_service_config.channels[i].channel = rx_receivers[i].channel;
+#if IR_RX_EDGE_TIMING
+        rx_service_config.channels[i].edge_gpio = rx_receivers[i].gpio; // times the delivery of each burst
+#endif
+        rx_service_config.channels[i].parser = ir_parser_rmt_new_dispatch_static(&ir_parser_config, s_rx_protocols,
+                                                                                 IR_RX_NUM_PROTOCOLS, s_parser_storage[i],
+                                                                                 sizeof(s_parser_storage[i]));
+    }
+    // Longer glitches than the hardware filter catches are merged in software, well below the shortest
+    // level of a frame (560 us less the margin)
+    rx_service_config.glitch_us = IR_RX_GLITCH_US;
+#if IR_RX_CAPTURE_BYTES
+    rx_service_config.on_items = ir_rx_items;
+#endif
+    rx_service_config.task_stack_size = sizeof(s_rx_service_stack);
+    rx_service_config.task_core = IR_RX_CORE;
+    rx_service_config.trace = &s_trace;
+#if IR_RX_EDGE_TIMING
+    // Edge timestamps of the receivers; another component may have installed the service already
+    esp_err_t ret = gpio_install_isr_service(0);
+    ESP_ERROR_CHECK(ret == ESP_ERR_INVALID_STATE ? ESP_OK : ret);
+#endif
+
+    ir_rx_service_t *rx_service = NULL;
+    ESP_ERROR_CHECK(ir_rx_service_new_static(&rx_service_config, s_rx_service_stack, &s_rx_service_storage, &rx_service));
+    return rx_service;
+}
+
+/**
+ * @brief Report how much of its stack every task never used, to size them, and the latencies of RX and TX
+ *
+ */
+static void report_task(void *arg)
+{
+    static const char *const rx_stages[IR_RX_LATENCY_MAX] = {"rx deliver", "rx input", "rx decode", "rx total"};
+    static const char *const tx_stages[IR_TX_LATENCY_MAX] = {"tx build", "tx send"};
+    ir_latency_hist_t hist;
+    while (1) {
+        vTaskDelay(pdMS_TO_TICKS(IR_REPORT_MS));
+        for (uint32_t i = 0; i < STACK_MAX; i++) {
+            if (s_stack_tasks[i]) {
+                ESP_LOGI(TAG, "stack %-16s %u bytes never used", pcTaskGetName(s_stack_tasks[i]),
+                         (unsigned)(uxTaskGetStackHighWaterMark(s_stack_tasks[i]) * sizeof(StackType_t)));
             }
-            //after parsing the data, return spaces to ringbuffer.
-            vRingbufferReturnItem(rb, (void *) items);
-            if (0) {break;}
+        }
+        for (uint32_t i = 0; s_rx_service && i < IR_RX_LATENCY_MAX; i++) {
+            ir_rx_service_get_latency(s_rx_service, i, &hist);
+            ir_latency_dump(&hist, rx_stages[i]);
+        }
+        for (uint32_t i = 0; s_tx_service && i < IR_TX_LATENCY_MAX; i++) {
+            ir_tx_service_get_latency(s_tx_service, i, &hist);
+            ir_latency_dump(&hist, tx_stages[i]);
         }
     }
-    ir_parser->del(ir_parser);
-    rmt_driver_uninstall(rx_rmt_chan);
     vTaskDelete(NULL);
 }
 
-static void debug_print_task(void *arg)
+/**
+ * @brief Log the trace: formatting and UART output stay out of the ISRs and the IR tasks
+ *
+ */
+static void trace_task(void *arg)
 {
-    while (1)
-    {
-        if (xSemaphoreTake(xSemaphoreRmtTx, portMAX_DELAY) == pdTRUE)
-        {
-            ESP_LOGI(TAG, "rmt_tx_cmplt");
+    ir_trace_record_t record;
+    uint32_t dropped = 0;
+    while (1) {
+        vTaskDelay(pdMS_TO_TICKS(IR_TRACE_DRAIN_MS));
+        while (ir_trace_read(&s_trace, &record) == ESP_OK) {
+            ESP_LOGI(TAG, "trace %10u us %-11s ch %u 0x%08x", record.timestamp_us, ir_trace_event_name(record.event),
+                     record.channel, record.payload);
         }
-        if (xSemaphoreTake(xSemaphoreRmtRx, portMAX_DELAY) == pdTRUE)
-        {
-            ESP_LOGI(TAG, "rmt_rx_line_active");
+        if (ir_trace_get_dropped(&s_trace) != dropped) {
+            dropped = ir_trace_get_dropped(&s_trace);
+            ESP_LOGW(TAG, "trace: %u events dropped so far", dropped);
         }
     }
     vTaskDelete(NULL);
@@ -160,9 +360,16 @@ static void debug_print_task(void *arg)
 
 void app_main(void)
 {
-    xSemaphoreRmtTx = xSemaphoreCreateBinary();
-    xSemaphoreRmtRx = xSemaphoreCreateBinary();
-    xTaskCreate(debug_print_task, "debug_print_task", 2048, NULL, 9, NULL);
-    xTaskCreate(ir_tx_task, "ir_tx_task", 2048, NULL, 10, NULL);
-    xTaskCreate(ir_rx_task, "ir_rx_task", 2048, NULL, 11, NULL);
-}
\ No newline at end of file
+    ESP_ERROR_CHECK(ir_trace_init(&s_trace, s_trace_slots, IR_TRACE_SLOTS));
+    s_stack_tasks[STACK_TRACE] = xTaskCreateStaticPinnedToCore(trace_task, "ir_trace", sizeof(s_trace_stack), NULL, 1,
+                                                               s_trace_stack, &s_task_buffers[STACK_TRACE], IR_TX_CORE);
+    s_stack_tasks[STACK_TX] = xTaskCreateStaticPinnedToCore(ir_tx_task, "ir_tx_task", sizeof(s_tx_stack), NULL, 10,
+                                                            s_tx_stack, &s_task_buffers[STACK_TX], IR_TX_CORE);
+    s_rx_service = ir_rx_start();
+    ESP_ERROR_CHECK(ir_rx_service_get_task(s_rx_service, &s_stack_tasks[STACK_RX_SERVICE]));
+    if (IR_REPORT_MS) {
+        s_stack_tasks[STACK_REPORT] = xTaskCreateStaticPinnedToCore(report_task, "ir_report", sizeof(s_report_stack), NULL, 1,
+                                                                    s_report_stack, &s_task_buffers[STACK_REPORT],
+                                                                    IR_TX_CORE);
+    }
+}